@@ -20,6 +20,7 @@ use ieee.std_logic_1164.all;
 use ieee.numeric_std.all;
 
 library xil_defaultlib;
+use xil_defaultlib.types_pkg.all;
 
 entity display_sd is
     generic (
@@ -37,11 +38,12 @@ entity display_sd is
 
         bram_en     : in    std_logic;                      -- character buffer enable
         bram_we     : in    std_logic_vector(3 downto 0);
-        bram_addr   : in    std_logic_vector(15 downto 0);
+        bram_addr   : in    std_logic_vector(15 downto 0);  -- 4 pages of 8kBytes (bits 14..13 select page)
         bram_din    : in    std_logic_vector(31 downto 0);
         bram_dout   : out   std_logic_vector(31 downto 0);
 
         pal_ntsc    : in    std_logic;
+        page        : in    std_logic_vector(1 downto 0);   -- displayed page (character buffer bank)
         border      : in    std_logic_vector(3 downto 0);
 
         dvi_clk_p   : out   std_logic;                      -- DVI TMDS clock (differential, P)
@@ -60,6 +62,14 @@ architecture synth of display_sd is
     signal char_buf_addr    : std_logic_vector(12 downto 1);    -- 4k x 16
     signal char_buf_data    : std_logic_vector(15 downto 0);    -- attribute + character code
 
+    signal page_s           : slv_1_0_t(0 to 1);                -- page, synchronised to pixel clock
+    signal disp_page        : std_logic_vector(1 downto 0);     -- displayed page, updated at vertical sync
+    signal disp_page_d      : std_logic_vector(1 downto 0);     -- displayed page, aligned with char_buf_data
+    signal char_buf_en_a    : std_logic_vector(0 to 3);
+    signal char_buf_dout_a  : slv_31_0_t(0 to 3);
+    signal char_buf_dout_b  : slv_15_0_t(0 to 3);
+    signal bram_page_d      : std_logic_vector(1 downto 0);     -- CPU page, aligned with char_buf_dout_a
+
     signal char_rom_row     : std_logic_vector(3 downto 0);
     signal char_rom_data    : std_logic_vector(7 downto 0);
 
@@ -180,6 +190,9 @@ begin
             if pix_rst = '1' then
 
                 char_buf_addr       <= (others => '0');
+                page_s              <= (others => (others => '0'));
+                disp_page           <= (others => '0');
+                disp_page_d         <= (others => '0');
                 char_rom_row        <= (others => '0');
                 char_sr             <= (others => '0');
                 char_attr           <= (others => '0');
@@ -207,6 +220,14 @@ begin
                     + resize(cx,a'length); -- a = (y*80) + x
                 char_buf_addr <= std_logic_vector(a);
 
+                -- page select: synchronise, change only at vertical sync
+                page_s(0) <= page;
+                page_s(1) <= page_s(0);
+                if raw_vs = '1' then
+                    disp_page <= page_s(1);
+                end if;
+                disp_page_d <= disp_page;
+
                 -- character row
                 char_rom_row <= raw_ay(3 downto 0) xor (not pal_ntsc) & "000";
 
@@ -271,25 +292,41 @@ begin
         end if;
     end process;
 
-    -- 8kByte character buffer; 4k x 16 on A (display) port, 2k x 32 on B (CPU) port
-
-    CHAR_BUF: entity xil_defaultlib.ram_4kx16_2kx32
-        port map(
-            clk_a   => sys_clk,
-            clr_a   => '0',
-            en_a    => bram_en,
-            we_a    => bram_we,
-            addr_a  => bram_addr(12 downto 2),
-            din_a   => bram_din,
-            dout_a  => bram_dout,
-            clk_b   => pix_clk,
-            clr_b   => '0',
-            en_b    => '1',
-            we_b    => (others => '0'),
-            addr_b  => char_buf_addr,
-            din_b   => (others => '0'),
-            dout_b  => char_buf_data
-        );
+    -- 4 pages of 8kByte character buffer; 4k x 16 on B (display) port, 2k x 32 on A (CPU) port
+
+    process(sys_clk)
+    begin
+        if rising_edge(sys_clk) then
+            bram_page_d <= bram_addr(14 downto 13);
+        end if;
+    end process;
+
+    bram_dout <= char_buf_dout_a(to_integer(unsigned(bram_page_d)));
+    char_buf_data <= char_buf_dout_b(to_integer(unsigned(disp_page_d)));
+
+    GEN_CHAR_BUF: for i in 0 to 3 generate
+
+        char_buf_en_a(i) <= bram_en when to_integer(unsigned(bram_addr(14 downto 13))) = i else '0';
+
+        CHAR_BUF: entity xil_defaultlib.ram_4kx16_2kx32
+            port map(
+                clk_a   => sys_clk,
+                clr_a   => '0',
+                en_a    => char_buf_en_a(i),
+                we_a    => bram_we,
+                addr_a  => bram_addr(12 downto 2),
+                din_a   => bram_din,
+                dout_a  => char_buf_dout_a(i),
+                clk_b   => pix_clk,
+                clr_b   => '0',
+                en_b    => '1',
+                we_b    => (others => '0'),
+                addr_b  => char_buf_addr,
+                din_b   => (others => '0'),
+                dout_b  => char_buf_dout_b(i)
+            );
+
+    end generate GEN_CHAR_BUF;
 
     -- character ROM (256 patterns x 8 pixels wide x 16 rows high)
 
@@ -135,6 +135,7 @@ begin
             bram_din    => bram_din,
             bram_dout   => bram_dout,
             pal_ntsc    => gpo(0),
+            page        => gpo(2 downto 1),
             border      => gpo(7 downto 4),
             dvi_clk_p   => dvi_clk_p,
             dvi_clk_n   => dvi_clk_n,
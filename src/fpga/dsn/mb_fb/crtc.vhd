@@ -42,7 +42,11 @@ package crtc_pkg is
             fb_vs       : out    std_logic;
             fb_hs       : out    std_logic;
             fb_vblank   : out    std_logic;
-            fb_hblank   : out    std_logic
+            fb_hblank   : out    std_logic;
+
+            sys_vs      : out   std_logic;                      -- vertical sync     } system clock
+            sys_vblank  : out   std_logic;                      -- vertical blank    } domain, for
+            sys_ay      : out   std_logic_vector(11 downto 0)   -- scanline (signed) } CPU polling
 
         );
     end component crtc;
@@ -55,6 +59,9 @@ library ieee;
 use ieee.std_logic_1164.all;
 use ieee.numeric_std.all;
 
+library xpm;
+use xpm.vcomponents.all;
+
 library work;
 use work.video_mode_pkg.all;
 use work.video_out_clock_pkg.all;
@@ -85,7 +92,11 @@ entity crtc is
         fb_vs       : out    std_logic;
         fb_hs       : out    std_logic;
         fb_vblank   : out    std_logic;
-        fb_hblank   : out    std_logic
+        fb_hblank   : out    std_logic;
+
+        sys_vs      : out   std_logic;                      -- vertical sync     } system clock
+        sys_vblank  : out   std_logic;                      -- vertical blank    } domain, for
+        sys_ay      : out   std_logic_vector(11 downto 0)   -- scanline (signed) } CPU polling
 
     );
 end entity crtc;
@@ -114,6 +125,13 @@ architecture synth of crtc is
 
     signal tmds             : slv_9_0_t(0 to 2);                -- parallel TMDS channels
 
+    signal vs               : std_logic;
+    signal vblank           : std_logic;
+    signal ay               : std_logic_vector(11 downto 0);    -- active area Y (signed)
+    signal beam_p           : std_logic_vector(13 downto 0);    -- vs, vblank, ay
+    signal beam_s           : std_logic_vector(13 downto 0);    -- beam_p synchronised to sclk
+    signal beam_s1          : std_logic_vector(13 downto 0);    -- beam_s delayed
+
 begin
 
     -- video mode timings
@@ -139,7 +157,10 @@ begin
             hs_pol    => mode_hs_pol
         );
 
-    fb_llen <= mode_h_act(10 downto 6);
+    -- line length in 64 pixel chunks, rounded up (e.g. 720 => 12 => 768)
+    fb_llen <=
+        std_logic_vector(unsigned(mode_h_act(10 downto 6))+1) when mode_h_act(5 downto 0) /= "000000" else
+        mode_h_act(10 downto 6);
 
     -- reconfigurable MMCM: 100MHz ref => 25.2MHz, 27MHz, 74.25MHz or 148.5MHz
 
@@ -173,12 +194,54 @@ begin
             h_bp      => mode_h_bp,
             align     => (others => '0'),
             f         => open,
-            vs        => fb_vs,
+            vs        => vs,
             hs        => fb_hs,
-            vblank    => fb_vblank,
+            vblank    => vblank,
             hblank    => fb_hblank,
             ax        => open,
-            ay        => open
+            ay        => ay
         );
 
+    fb_vs <= vs;
+    fb_vblank <= vblank;
+
+    -- beam position for the CPU: the bits are synchronised individually,
+    -- and only passed on when 2 successive samples agree (they change at
+    -- most twice per line, so this never misses a position for long)
+
+    beam_p <= vs & vblank & ay;
+
+    SYNC_BEAM : xpm_cdc_array_single
+        generic map (
+            dest_sync_ff    => 2,
+            init_sync_ff    => 1,
+            sim_assert_chk  => 1,
+            src_input_reg   => 0,
+            width           => 14
+        )
+        port map (
+            src_clk         => pclk,
+            src_in          => beam_p,
+            dest_clk        => sclk,
+            dest_out        => beam_s
+        );
+
+    process(sclk)
+    begin
+        if rising_edge(sclk) then
+            beam_s1 <= beam_s;
+            if beam_s = beam_s1 then
+                sys_vs <= beam_s(13);
+                sys_vblank <= beam_s(12);
+                sys_ay <= beam_s(11 downto 0);
+            end if;
+            if srst = '1' then
+                beam_s1 <= (others => '0');
+                sys_vs <= '0';
+                sys_vblank <= '0';
+                sys_ay <= (others => '0');
+            end if;
+        end if;
+    end process;
+
 end architecture synth;
@@ -153,6 +153,10 @@ architecture synth of mb_fb is
     signal crtc_r       : std_logic_vector(7 downto 0);
     signal crtc_g       : std_logic_vector(7 downto 0);
     signal crtc_b       : std_logic_vector(7 downto 0);
+    signal page_disp    : std_logic;
+    signal beam_vs      : std_logic;
+    signal beam_vblank  : std_logic;
+    signal beam_ay      : std_logic_vector(11 downto 0);
 
     -- MIG hub
     signal hub_awvalid  : std_logic_vector(0 to mig_hub_ports-1);
@@ -199,7 +203,7 @@ architecture synth of mb_fb is
 begin
 
     mode <= gpo(3 downto 0);
-    gpi <= (0 => mig_cc, others => '0');
+    gpi <= "0000" & beam_ay & "000000000" & beam_vs & beam_vblank & page_disp & "000" & mig_cc;
 
     U_CPU: entity work.microblaze
         port map (
@@ -282,13 +286,16 @@ begin
             fb_vs       => crtc_vs,
             fb_hs       => crtc_hs,
             fb_vblank   => crtc_vblank,
-            fb_hblank   => crtc_hblank
+            fb_hblank   => crtc_hblank,
+            sys_vs      => beam_vs,
+            sys_vblank  => beam_vblank,
+            sys_ay      => beam_ay
         );
 
     U_BRIDGE_CRTC: component mig_bridge_crtc
         generic map (
             base_addr       => 0,
-            size_log2       => 23   -- 2^23 = 8MBytes (enough for 1920 x 1080 x 32 bpp)
+            size_log2       => 23   -- 2^23 = 8MBytes (enough for 1920 x 1080 x 32 bpp) per page
         )
         port map (
             crtc_clk        => pclk,
@@ -311,6 +318,10 @@ begin
             mig_wbe         => hub_wbe(0),
             mig_rdata       => hub_rdata,
             mig_rvalid      => hub_rvalid(0),
+            mig_page        => gpo(4),
+            mig_page_disp   => page_disp,
+            mig_fmt         => gpo(6 downto 5),
+            mig_scale       => gpo(8 downto 7),
             fifo_underflow  => debug(0),
             fifo_overflow   => debug(1)
         );
@@ -127,6 +127,7 @@ xilinx.com:ip:mdm:3.2\
 xilinx.com:ip:axi_gpio:2.0\
 xilinx.com:ip:proc_sys_reset:5.0\
 xilinx.com:ip:axi_uartlite:2.0\
+xilinx.com:ip:axi_timer:2.0\
 xilinx.com:ip:lmb_bram_if_cntlr:4.0\
 xilinx.com:ip:lmb_v10:3.0\
 xilinx.com:ip:blk_mem_gen:8.4\
@@ -311,10 +312,16 @@ proc create_root_design { parentCell } {
   # Create instance: cpu, and set properties
   set cpu [ create_bd_cell -type ip -vlnv xilinx.com:ip:microblaze:11.0 cpu ]
   set_property -dict [ list \
+   CONFIG.C_DCACHE_BASEADDR {0x0000000080000000} \
+   CONFIG.C_DCACHE_BYTE_SIZE {8192} \
+   CONFIG.C_DCACHE_HIGHADDR {0x000000009FFFFFFF} \
+   CONFIG.C_DCACHE_LINE_LEN {8} \
+   CONFIG.C_DCACHE_USE_WRITEBACK {1} \
    CONFIG.C_DEBUG_ENABLED {1} \
    CONFIG.C_D_AXI {1} \
    CONFIG.C_D_LMB {1} \
    CONFIG.C_I_LMB {1} \
+   CONFIG.C_USE_DCACHE {1} \
    CONFIG.G_TEMPLATE_LIST {8} \
  ] $cpu
 
@@ -333,7 +340,8 @@ proc create_root_design { parentCell } {
   set interconnect [ create_bd_cell -type ip -vlnv xilinx.com:ip:axi_interconnect:2.1 interconnect ]
   set_property -dict [ list \
    CONFIG.ENABLE_ADVANCED_OPTIONS {0} \
-   CONFIG.NUM_MI {3} \
+   CONFIG.NUM_MI {4} \
+   CONFIG.NUM_SI {2} \
  ] $interconnect
 
   # Create instance: ram
@@ -346,6 +354,9 @@ proc create_root_design { parentCell } {
    CONFIG.USE_BOARD_FLOW {true} \
  ] $rstctrl
 
+  # Create instance: timer, and set properties
+  set timer [ create_bd_cell -type ip -vlnv xilinx.com:ip:axi_timer:2.0 timer ]
+
   # Create instance: uart, and set properties
   set uart [ create_bd_cell -type ip -vlnv xilinx.com:ip:axi_uartlite:2.0 uart ]
   set_property -dict [ list \
@@ -354,6 +365,7 @@ proc create_root_design { parentCell } {
 
   # Create interface connections
   connect_bd_intf_net -intf_net axi_uartlite_0_UART [get_bd_intf_ports uart] [get_bd_intf_pins uart/UART]
+  connect_bd_intf_net -intf_net cpu_M_AXI_DC [get_bd_intf_pins cpu/M_AXI_DC] [get_bd_intf_pins interconnect/S01_AXI]
   connect_bd_intf_net -intf_net cpu_M_AXI_DP [get_bd_intf_pins cpu/M_AXI_DP] [get_bd_intf_pins interconnect/S00_AXI]
   connect_bd_intf_net -intf_net cpu_debug [get_bd_intf_pins cpu/DEBUG] [get_bd_intf_pins debug/MBDEBUG_0]
   connect_bd_intf_net -intf_net cpu_dlmb_1 [get_bd_intf_pins cpu/DLMB] [get_bd_intf_pins ram/DLMB]
@@ -362,15 +374,16 @@ proc create_root_design { parentCell } {
   connect_bd_intf_net -intf_net interconnect_M00_AXI [get_bd_intf_ports axi] [get_bd_intf_pins interconnect/M00_AXI]
   connect_bd_intf_net -intf_net interconnect_M01_AXI [get_bd_intf_pins interconnect/M01_AXI] [get_bd_intf_pins uart/S_AXI]
   connect_bd_intf_net -intf_net interconnect_M02_AXI [get_bd_intf_pins gpio/S_AXI] [get_bd_intf_pins interconnect/M02_AXI]
+  connect_bd_intf_net -intf_net interconnect_M03_AXI [get_bd_intf_pins interconnect/M03_AXI] [get_bd_intf_pins timer/S_AXI]
 
   # Create port connections
-  connect_bd_net -net cpu_Clk [get_bd_ports clk] [get_bd_pins cpu/Clk] [get_bd_pins gpio/s_axi_aclk] [get_bd_pins interconnect/ACLK] [get_bd_pins interconnect/M00_ACLK] [get_bd_pins interconnect/M01_ACLK] [get_bd_pins interconnect/M02_ACLK] [get_bd_pins interconnect/S00_ACLK] [get_bd_pins ram/Clk] [get_bd_pins rstctrl/slowest_sync_clk] [get_bd_pins uart/s_axi_aclk]
+  connect_bd_net -net cpu_Clk [get_bd_ports clk] [get_bd_pins cpu/Clk] [get_bd_pins gpio/s_axi_aclk] [get_bd_pins interconnect/ACLK] [get_bd_pins interconnect/M00_ACLK] [get_bd_pins interconnect/M01_ACLK] [get_bd_pins interconnect/M02_ACLK] [get_bd_pins interconnect/M03_ACLK] [get_bd_pins interconnect/S00_ACLK] [get_bd_pins interconnect/S01_ACLK] [get_bd_pins ram/Clk] [get_bd_pins rstctrl/slowest_sync_clk] [get_bd_pins timer/s_axi_aclk] [get_bd_pins uart/s_axi_aclk]
   connect_bd_net -net mdm_1_debug_sys_rst [get_bd_pins debug/Debug_SYS_Rst] [get_bd_pins rstctrl/mb_debug_sys_rst]
   connect_bd_net -net reset_rtl_1 [get_bd_ports rsti_n] [get_bd_pins rstctrl/ext_reset_in]
   connect_bd_net -net rst_Clk_100M_bus_struct_reset [get_bd_pins ram/SYS_Rst] [get_bd_pins rstctrl/bus_struct_reset]
   connect_bd_net -net rst_Clk_100M_mb_reset [get_bd_pins cpu/Reset] [get_bd_pins rstctrl/mb_reset]
   connect_bd_net -net rstctrl_peripheral_reset [get_bd_ports rsto] [get_bd_pins rstctrl/peripheral_reset]
-  connect_bd_net -net sysrst_interconnect_aresetn [get_bd_pins gpio/s_axi_aresetn] [get_bd_pins interconnect/ARESETN] [get_bd_pins interconnect/M00_ARESETN] [get_bd_pins interconnect/M01_ARESETN] [get_bd_pins interconnect/M02_ARESETN] [get_bd_pins interconnect/S00_ARESETN] [get_bd_pins rstctrl/interconnect_aresetn] [get_bd_pins uart/s_axi_aresetn]
+  connect_bd_net -net sysrst_interconnect_aresetn [get_bd_pins gpio/s_axi_aresetn] [get_bd_pins interconnect/ARESETN] [get_bd_pins interconnect/M00_ARESETN] [get_bd_pins interconnect/M01_ARESETN] [get_bd_pins interconnect/M02_ARESETN] [get_bd_pins interconnect/M03_ARESETN] [get_bd_pins interconnect/S00_ARESETN] [get_bd_pins interconnect/S01_ARESETN] [get_bd_pins rstctrl/interconnect_aresetn] [get_bd_pins timer/s_axi_aresetn] [get_bd_pins uart/s_axi_aresetn]
 
   # Create address segments
   assign_bd_address -offset 0x80000000 -range 0x80000000 -target_address_space [get_bd_addr_spaces cpu/Data] [get_bd_addr_segs axi/Reg] -force
@@ -378,6 +391,7 @@ proc create_root_design { parentCell } {
   assign_bd_address -offset 0x40010000 -range 0x00010000 -target_address_space [get_bd_addr_spaces cpu/Data] [get_bd_addr_segs gpio/S_AXI/Reg] -force
   assign_bd_address -offset 0x00000000 -range 0x00010000 -target_address_space [get_bd_addr_spaces cpu/Instruction] [get_bd_addr_segs ram/ilmb_bram_if_cntlr/SLMB/Mem] -force
   assign_bd_address -offset 0x40000000 -range 0x00010000 -target_address_space [get_bd_addr_spaces cpu/Data] [get_bd_addr_segs uart/S_AXI/Reg] -force
+  assign_bd_address -offset 0x41C00000 -range 0x00010000 -target_address_space [get_bd_addr_spaces cpu/Data] [get_bd_addr_segs timer/S_AXI/Reg] -force
 
   # Perform GUI Layout
   regenerate_bd_layout -layout_string {
@@ -402,6 +416,7 @@ preplace inst ram -pg 1 -lvl 3 -x 1213 -y 550 -defaultsOSRD
 preplace inst rstctrl -pg 1 -lvl 2 -x 770 -y 900 -defaultsOSRD
 preplace inst uart -pg 1 -lvl 4 -x 1528 -y 970 -defaultsOSRD
 preplace inst gpio -pg 1 -lvl 4 -x 1528 -y 1130 -defaultsOSRD
+preplace inst timer -pg 1 -lvl 4 -x 1528 -y 1290 -defaultsOSRD
 preplace netloc cpu_Clk 1 0 4 N 670 510 560 1030 1030 1370
 preplace netloc mdm_1_debug_sys_rst 1 1 1 500 550n
 preplace netloc reset_rtl_1 1 0 2 NJ 690 490
@@ -418,6 +433,7 @@ preplace netloc interconnect_M01_AXI 1 3 1 1380 870n
 preplace netloc interconnect_M00_AXI 1 3 2 NJ 850 N
 preplace netloc gpio_GPIO 1 4 1 N 1130
 preplace netloc cpu_M_AXI_DP 1 2 1 1010 470n
+preplace netloc cpu_M_AXI_DC 1 2 1 1000 490n
 levelinfo -pg 1 0 383 770 1213 1528 1670
 pagesize -pg 1 -db -bbox -sgen -100 -10 1790 1710
 "
@@ -117,7 +117,8 @@ architecture synth of mig_bridge_axi is
 
     constant ratio : integer := 2**(data_width_log2-2);
 
-    signal sel : integer range 0 to ratio-1;
+    signal sel  : integer range 0 to ratio-1;  -- read word select
+    signal wsel : integer range 0 to ratio-1;  -- write word select
 
     -- signal cache_addr   : std_logic_vector(mig_addr'range);
     -- signal cache_data   : std_logic_vector(mig_wdata'range);
@@ -147,7 +148,10 @@ begin
 
     -- cache_hit <= '1' when cache_valid = '1' and cache_addr = axi_araddr(mig_addr'range) else '0';
 
+    -- the read and write address channels are independent (the cached and
+    -- uncached CPU data ports share this port via the interconnect)
     sel <= to_integer(unsigned(axi_araddr(data_width_log2-1 downto 2)));
+    wsel <= to_integer(unsigned(axi_awaddr(data_width_log2-1 downto 2)));
 
     axi_awready(0) <= axi_awvalid(0) and axi_wvalid(0) and mig_awready;
     axi_wready(0) <= axi_awvalid(0) and axi_wvalid(0) and mig_awready;
@@ -163,7 +167,7 @@ begin
     mig_addr <= axi_araddr(mig_addr'range) when (axi_arvalid(0) and not (axi_awvalid(0) and axi_wvalid(0))) = '1' else axi_awaddr(mig_addr'range);
     GEN_W: for i in 0 to ratio-1 generate
         mig_wdata(31+(i*32) downto i*32) <= axi_wdata;
-        mig_wbe(3+(i*4) downto i*4) <= (others => '1') when i = sel else (others => '0');
+        mig_wbe(3+(i*4) downto i*4) <= axi_wstrb when i = wsel else (others => '0');
     end generate GEN_W;    
     mig_rready <= '1';
 
@@ -52,6 +52,10 @@ package mig_bridge_crtc_pkg is
             mig_rdata       : in    std_logic_vector(2**(data_width_log2+3)-1 downto 0);
             mig_rvalid      : in    std_logic;
             mig_rready      : out   std_logic;
+            mig_page        : in    std_logic;  -- page to display from next frame
+            mig_page_disp   : out   std_logic;  -- page being displayed
+            mig_fmt         : in    std_logic_vector(1 downto 0); -- pixel format (see below)
+            mig_scale       : in    std_logic_vector(1 downto 0); -- pixel/line replication (see below)
 
             fifo_underflow  : out   std_logic;
             fifo_overflow   : out   std_logic
@@ -105,6 +109,10 @@ entity mig_bridge_crtc is
         mig_rdata       : in    std_logic_vector(2**(data_width_log2+3)-1 downto 0);
         mig_rvalid      : in    std_logic;
         mig_rready      : out   std_logic;
+        mig_page        : in    std_logic;  -- page to display from next frame
+        mig_page_disp   : out   std_logic;  -- page being displayed
+        mig_fmt         : in    std_logic_vector(1 downto 0); -- pixel format (see below)
+        mig_scale       : in    std_logic_vector(1 downto 0); -- pixel/line replication (see below)
 
         fifo_underflow  : out   std_logic;
         fifo_overflow   : out   std_logic
@@ -112,24 +120,98 @@ entity mig_bridge_crtc is
     );
 end entity mig_bridge_crtc;
 
+-- Pixel formats (mig_fmt, latched at vertical sync):
+--  "00" : 32 bpp - byte 0 = red, 1 = green, 2 = blue, 3 = unused
+--  "01" : 16 bpp - RGB565 (red in bits 15:11)
+--  "10" : 8 bpp - palette index; the palette (256 entries in 32 bpp
+--         format) is located just after the 2 pages of frame buffer
+--         memory, and is read from memory at the end of each vertical
+--         sync pulse, so it may be updated at any time
+-- Pixels are unpacked after the FIFO, which holds raw 32 bit words.
+-- Lines are fetched in whole 64 pixel chunks (so the line pitch in memory
+-- is the active width rounded up to a multiple of 64 pixels); any surplus
+-- beyond the active width is discarded from the FIFO during horizontal
+-- blanking.
+-- Replication (mig_scale, latched at vertical sync):
+--  "00" : none
+--  "01" : 2x - each pixel and line is displayed twice
+--  "10" : 4x - each pixel and line is displayed 4 times
+-- so that e.g. a 960x540 or 480x270 frame buffer fills a 1920x1080
+-- display. The line pitch is then the reduced width rounded up to a
+-- multiple of 64 pixels. Each line is fetched from memory once, and kept
+-- in a line buffer to be displayed again.
+
 architecture synth of mig_bridge_crtc is
 
     constant base_addr_v : std_logic_vector(31 downto 0) := std_logic_vector(to_unsigned(base_addr,32));
     constant ratio : integer := 2**(data_width_log2-2); -- ratio of MIG UI data width (e.g. 128 bits) to pixel width (32 bits)
+    constant ratio_log2 : integer := data_width_log2-2;
 
+    -- line length in 64 pixel chunks after replication (rounded up)
+    function scale_llen(llen : std_logic_vector; scale : std_logic_vector(1 downto 0)) return std_logic_vector is
+    begin
+        case scale is
+            when "00"   => return llen;
+            when "01"   => return std_logic_vector(resize(shift_right(resize(unsigned(llen),llen'length+1)+1,1),llen'length));
+            when others => return std_logic_vector(resize(shift_right(resize(unsigned(llen),llen'length+1)+3,2),llen'length));
+        end case;
+    end function scale_llen;
+
+    signal crtc_lreq_raw    : std_logic;
+    signal crtc_lreq_raw_d  : std_logic;
     signal crtc_lreq        : std_logic;
     signal crtc_lreq_s      : std_logic_vector(0 to 1);
     signal crtc_vs_s        : std_logic_vector(0 to 1);
 
     signal fifo_ef          : std_logic;
     signal fifo_aff         : std_logic;
-    signal fifo_wdata       : std_logic_vector(ratio*24-1 downto 0);
+    signal fifo_we          : std_logic;
+    signal fifo_re          : std_logic;
+    signal fifo_dout        : std_logic_vector(31 downto 0);
     signal fifo_wcount      : std_logic_vector(13-data_width_log2 downto 0);
     signal fifo_rcount      : std_logic_vector(11 downto 0);
 
-    type state_cmd_t is (IDLE, BUSY);
+    type state_cmd_t is (IDLE, BUSY, PAL);
     signal state_cmd        : state_cmd_t;
     signal count            : std_logic_vector(crtc_llen'range);
+    signal fmt              : std_logic_vector(1 downto 0);  -- pixel format (mig_clk domain)
+    signal scale            : std_logic_vector(1 downto 0);  -- replication (mig_clk domain)
+    signal src_llen         : std_logic_vector(crtc_llen'range); -- line length to fetch
+    signal chunk_end        : std_logic;                      -- last MIG word of 64 pixel chunk
+
+    type pal_bank_t is array(0 to (256/ratio)-1) of std_logic_vector(23 downto 0);
+    type pal_t is array(0 to ratio-1) of pal_bank_t;
+    signal pal              : pal_t;
+    attribute ram_style : string;
+    attribute ram_style of pal : signal is "distributed";
+    signal pal_load         : std_logic;
+    signal pal_wptr         : std_logic_vector(7-ratio_log2 downto 0);
+
+    signal crtc_fmt_s       : std_logic_vector(1 downto 0);
+    signal crtc_fmt         : std_logic_vector(1 downto 0);  -- pixel format (crtc_clk domain)
+    signal crtc_scale_s     : std_logic_vector(1 downto 0);
+    signal crtc_scale       : std_logic_vector(1 downto 0);  -- replication (crtc_clk domain)
+    signal crtc_mask        : std_logic_vector(1 downto 0);  -- replications - 1
+    signal crtc_src_llen    : std_logic_vector(crtc_llen'range);
+    signal crtc_lcount      : std_logic_vector(1 downto 0);  -- line within group (requests)
+    signal crtc_lrep        : std_logic_vector(1 downto 0);  -- line within group (display)
+    signal crtc_lfirst      : std_logic;                      -- first line of group: pixels from FIFO
+    signal crtc_ldrain      : std_logic;                      -- line just displayed was from FIFO
+    signal crtc_hrep        : std_logic_vector(1 downto 0);  -- repetition of pixel
+    signal crtc_adv         : std_logic;                      -- advance to next pixel
+    signal crtc_wadv        : std_logic;                      -- advance to next 32 bit word
+    signal crtc_w           : unsigned(9 downto 0);           -- word within line
+    signal crtc_w_next      : unsigned(9 downto 0);
+    type lbuf_t is array(0 to 1023) of std_logic_vector(31 downto 0);
+    signal lbuf             : lbuf_t;                         -- line buffer (up to 1024 words)
+    signal lbuf_q           : std_logic_vector(31 downto 0);
+    signal crtc_word        : std_logic_vector(31 downto 0);  -- word being displayed
+    signal crtc_active      : std_logic;
+    signal crtc_sub         : std_logic_vector(1 downto 0);  -- pixel within 32 bit word
+    signal crtc_active_d    : std_logic;
+    signal crtc_x           : std_logic_vector(11 downto 0);  -- pixels consumed from FIFO this line
+    signal crtc_drain       : std_logic;                      -- discard surplus word
+    signal crtc_pixel       : std_logic_vector(23 downto 0);
 
 begin
 
@@ -137,7 +219,32 @@ begin
     mig_wdata <= (others => '0');
     mig_wbe <= (others => '0');
 
-    crtc_lreq <= crtc_hs and not crtc_vblank; -- request a line of pixels
+    -- request a line of pixels (only the first of each group of replicated lines)
+
+    crtc_lreq_raw <= crtc_hs and not crtc_vblank;
+
+    process(crtc_clk)
+    begin
+        if rising_edge(crtc_clk) then
+            crtc_lreq_raw_d <= crtc_lreq_raw;
+            if crtc_lreq_raw = '1' and crtc_lreq_raw_d = '0' then
+                if crtc_lcount = "00" then
+                    crtc_lreq <= '1';
+                end if;
+                crtc_lcount <= std_logic_vector(unsigned(crtc_lcount)+1) and crtc_mask;
+            elsif crtc_lreq_raw = '0' then
+                crtc_lreq <= '0';
+            end if;
+            if crtc_vblank = '1' then
+                crtc_lcount <= (others => '0');
+            end if;
+            if crtc_rst = '1' then
+                crtc_lreq_raw_d <= '0';
+                crtc_lreq <= '0';
+                crtc_lcount <= (others => '0');
+            end if;
+        end if;
+    end process;
 
     SYNC : xpm_cdc_array_single
         generic map (
@@ -156,6 +263,14 @@ begin
             dest_out(0)            => crtc_lreq_s(0)
         );
 
+    -- a 64 pixel chunk is 16, 8 or 4 MIG words (for 128 bit MIG UI)
+    with fmt select chunk_end <=
+        and mig_addr(6 downto data_width_log2) when "01",
+        and mig_addr(5 downto data_width_log2) when "10",
+        and mig_addr(7 downto data_width_log2) when others;
+
+    src_llen <= scale_llen(crtc_llen, scale);
+
     process(mig_clk)
     begin
         if rising_edge(mig_clk) then
@@ -175,9 +290,9 @@ begin
                 when BUSY =>
                     if mig_awready = '1' then
                         mig_addr(size_log2-1 downto data_width_log2) <= std_logic_vector(unsigned(mig_addr(size_log2-1 downto data_width_log2))+1);
-                        if to_integer(signed(mig_addr(7 downto data_width_log2))) = -1 then -- completed 64 pixel chunk
+                        if chunk_end = '1' then -- completed 64 pixel chunk
                             count <= std_logic_vector(unsigned(count)+1);                            
-                            if count = std_logic_vector(unsigned(crtc_llen)-1) then -- completed line
+                            if count = std_logic_vector(unsigned(src_llen)-1) then -- completed line
                                 state_cmd <= IDLE;
                                 count <= (others => '0');
                                 mig_awvalid <= '0';
@@ -185,24 +300,73 @@ begin
                         end if;
                     end if;
 
+                when PAL => -- request 1kByte palette
+                    if mig_awready = '1' then
+                        mig_addr(size_log2-1 downto data_width_log2) <= std_logic_vector(unsigned(mig_addr(size_log2-1 downto data_width_log2))+1);
+                        if to_integer(signed(mig_addr(9 downto data_width_log2))) = -1 then -- completed palette
+                            state_cmd <= IDLE;
+                            mig_awvalid <= '0';
+                            mig_addr <= base_addr_v(mig_addr'range);
+                            mig_addr(size_log2) <= mig_page_disp;
+                        end if;
+                    end if;
+
             end case;
 
             if crtc_vs_s(0) = '1' and crtc_vs_s(1) = '0' then
                 mig_addr <= base_addr_v(mig_addr'range);
+                mig_addr(size_log2) <= mig_page;
+                mig_page_disp <= mig_page;
+                fmt <= mig_fmt;
+                scale <= mig_scale;
+            end if;
+
+            if crtc_vs_s(0) = '0' and crtc_vs_s(1) = '1' and fmt = "10" then -- end of vs: load palette
+                state_cmd <= PAL;
+                mig_awvalid <= '1';
+                mig_addr <= base_addr_v(mig_addr'range);
+                mig_addr(size_log2+1) <= '1';
+                pal_load <= '1';
+                pal_wptr <= (others => '0');
+            end if;
+
+            if pal_load = '1' and mig_rvalid = '1' then
+                pal_wptr <= std_logic_vector(unsigned(pal_wptr)+1);
+                if to_integer(signed(pal_wptr)) = -1 then
+                    pal_load <= '0';
+                end if;
             end if;
 
             if mig_rst = '1' or crtc_vs_s(0) = '1' then
                 state_cmd <= IDLE;
                 count <= (others => '0');
                 mig_awvalid <= '0';
+                pal_load <= '0';
+            end if;
+
+            if mig_rst = '1' then
+                mig_page_disp <= '0';
+                fmt <= (others => '0');
+                scale <= (others => '0');
             end if;
 
         end if;
     end process;
 
-    GEN_FIFO_WDATA: for i in 0 to ratio-1 generate
-        fifo_wdata(23+(i*24) downto i*24) <= mig_rdata(23+(i*32) downto i*32);
-    end generate GEN_FIFO_WDATA;
+    -- palette RAM: written in mig_clk domain (ratio entries at a time),
+    -- read asynchronously in crtc_clk domain
+    process(mig_clk)
+    begin
+        if rising_edge(mig_clk) then
+            if pal_load = '1' and mig_rvalid = '1' then
+                for i in 0 to ratio-1 loop
+                    pal(i)(to_integer(unsigned(pal_wptr))) <= mig_rdata(23+(i*32) downto i*32);
+                end loop;
+            end if;
+        end if;
+    end process;
+
+    fifo_we <= mig_rvalid and not pal_load;
 
     FIFO: xpm_fifo_async
         generic map (
@@ -211,19 +375,19 @@ begin
             ECC_MODE            => "no_ecc",
             FIFO_MEMORY_TYPE    => "auto",
             FIFO_READ_LATENCY   => 0,
-            FIFO_WRITE_DEPTH    => 2048/ratio,          -- enough for 2k pixels,
+            FIFO_WRITE_DEPTH    => 2048/ratio,          -- 2k words = 2k, 4k or 8k pixels
             FULL_RESET_VALUE    => 0,
             PROG_EMPTY_THRESH   => 16,
             PROG_FULL_THRESH    => 16,
-            RD_DATA_COUNT_WIDTH => 12,                  -- 2k pixels
-            READ_DATA_WIDTH     => 24,
+            RD_DATA_COUNT_WIDTH => 12,                  -- 2k words
+            READ_DATA_WIDTH     => 32,
             READ_MODE           => "fwft",
             RELATED_CLOCKS      => 0,
             SIM_ASSERT_CHK      => 0,
             USE_ADV_FEATURES    => "0101",              -- underflow, overflow
             WAKEUP_TIME         => 0,
-            WRITE_DATA_WIDTH    => fifo_wdata'length,
-            WR_DATA_COUNT_WIDTH => 14-data_width_log2   -- e.g. 10 c.w. 512 bursts of 4 pixels
+            WRITE_DATA_WIDTH    => mig_rdata'length,
+            WR_DATA_COUNT_WIDTH => 14-data_width_log2   -- e.g. 10 c.w. 512 bursts of 4 words
         )
         port map (
 
@@ -238,18 +402,16 @@ begin
             wr_clk              => mig_clk,
             wr_rst_busy         => open,
             wr_data_count       => fifo_wcount,
-            wr_en               => mig_rvalid,
+            wr_en               => fifo_we,
             wr_ack              => open,
-            din                 => fifo_wdata,
+            din                 => mig_rdata,
 
             rd_clk              => crtc_clk,
             rd_rst_busy         => open,
             rd_data_count       => fifo_rcount,
             data_valid          => open,
-            rd_en               => crtc_vblank nor crtc_hblank,
-            dout(7 downto 0)    => crtc_r,
-            dout(15 downto 8)   => crtc_g,
-            dout(23 downto 16)  => crtc_b,
+            rd_en               => fifo_re,
+            dout                => fifo_dout,
 
             empty               => fifo_ef,
             almost_empty        => open,
@@ -263,4 +425,140 @@ begin
 
         );
 
+    -- unpack pixels
+
+    SYNC_FMT : xpm_cdc_array_single
+        generic map (
+            dest_sync_ff    => 2,
+            init_sync_ff    => 1,
+            sim_assert_chk  => 1,
+            src_input_reg   => 0,
+            width           => 4
+        )
+        port map (
+            src_clk                => mig_clk,
+            src_in(3 downto 2)     => scale,
+            src_in(1 downto 0)     => fmt,
+            dest_clk               => crtc_clk,
+            dest_out(3 downto 2)   => crtc_scale_s,
+            dest_out(1 downto 0)   => crtc_fmt_s
+        );
+
+    crtc_active <= crtc_vblank nor crtc_hblank;
+
+    with crtc_scale select crtc_mask <=
+        "00" when "00",
+        "01" when "01",
+        "11" when others;
+
+    crtc_src_llen <= scale_llen(crtc_llen, crtc_scale);
+    crtc_adv <= '1' when crtc_hrep = crtc_mask else '0';
+    crtc_lfirst <= '1' when crtc_lrep = "00" else '0';
+
+    process(crtc_clk)
+    begin
+        if rising_edge(crtc_clk) then
+            if crtc_vblank = '1' then
+                crtc_fmt <= crtc_fmt_s;
+                crtc_scale <= crtc_scale_s;
+            end if;
+            if crtc_hblank = '1' then
+                crtc_sub <= (others => '0');
+                crtc_hrep <= (others => '0');
+            elsif crtc_active = '1' then
+                crtc_hrep <= std_logic_vector(unsigned(crtc_hrep)+1) and crtc_mask;
+                if crtc_adv = '1' then
+                    crtc_sub <= std_logic_vector(unsigned(crtc_sub)+1);
+                end if;
+            end if;
+            crtc_active_d <= crtc_active;
+            if crtc_active = '0' and crtc_active_d = '1' then
+                crtc_lrep <= std_logic_vector(unsigned(crtc_lrep)+1) and crtc_mask;
+            end if;
+            if crtc_active = '1' then
+                if crtc_active_d = '0' then
+                    crtc_x <= (0 => crtc_adv, others => '0');
+                    crtc_ldrain <= crtc_lfirst;
+                elsif crtc_adv = '1' then
+                    crtc_x <= std_logic_vector(unsigned(crtc_x)+1);
+                end if;
+            elsif crtc_drain = '1' then
+                crtc_x <= std_logic_vector(unsigned(crtc_x)+shift_left(to_unsigned(1,crtc_x'length),to_integer(unsigned(crtc_fmt))));
+            end if;
+            if crtc_vblank = '1' then
+                crtc_x <= '0' & crtc_llen & "000000";
+                crtc_lrep <= (others => '0');
+            end if;
+            if crtc_rst = '1' then
+                crtc_fmt <= (others => '0');
+                crtc_scale <= (others => '0');
+                crtc_sub <= (others => '0');
+                crtc_hrep <= (others => '0');
+                crtc_lrep <= (others => '0');
+                crtc_ldrain <= '0';
+                crtc_active_d <= '0';
+            end if;
+        end if;
+    end process;
+
+    crtc_drain <= '1' when crtc_hblank = '1' and crtc_vblank = '0' and crtc_ldrain = '1' and unsigned(crtc_x) < unsigned(crtc_src_llen & "000000") else '0';
+
+    with crtc_fmt select crtc_wadv <=
+        crtc_active and crtc_adv and crtc_sub(0) when "01",
+        crtc_active and crtc_adv and crtc_sub(0) and crtc_sub(1) when "10",
+        crtc_active and crtc_adv when others;
+
+    fifo_re <= (crtc_wadv and crtc_lfirst) or crtc_drain;
+
+    -- line buffer: words are stored as they are taken from the FIFO on the
+    -- first line of a group, and replayed on the other lines of the group
+    -- (the read address is that of the next word, so lbuf_q = lbuf(crtc_w))
+
+    crtc_w_next <=
+        (others => '0') when crtc_hblank = '1' else
+        crtc_w+1 when crtc_wadv = '1' else
+        crtc_w;
+
+    process(crtc_clk)
+    begin
+        if rising_edge(crtc_clk) then
+            if crtc_wadv = '1' and crtc_lfirst = '1' then
+                lbuf(to_integer(crtc_w)) <= fifo_dout;
+            end if;
+            lbuf_q <= lbuf(to_integer(crtc_w_next));
+            crtc_w <= crtc_w_next;
+        end if;
+    end process;
+
+    crtc_word <= fifo_dout when crtc_lfirst = '1' else lbuf_q;
+
+    process(crtc_fmt, crtc_sub, crtc_word, pal)
+        variable h : std_logic_vector(15 downto 0);
+        variable i : std_logic_vector(7 downto 0);
+    begin
+        case crtc_fmt is
+            when "01" =>
+                if crtc_sub(0) = '0' then
+                    h := crtc_word(15 downto 0);
+                else
+                    h := crtc_word(31 downto 16);
+                end if;
+                crtc_pixel <= h(4 downto 0) & h(4 downto 2) & h(10 downto 5) & h(10 downto 9) & h(15 downto 11) & h(15 downto 13);
+            when "10" =>
+                case crtc_sub is
+                    when "00"   => i := crtc_word(7 downto 0);
+                    when "01"   => i := crtc_word(15 downto 8);
+                    when "10"   => i := crtc_word(23 downto 16);
+                    when others => i := crtc_word(31 downto 24);
+                end case;
+                crtc_pixel <= pal(to_integer(unsigned(i(ratio_log2-1 downto 0))))(to_integer(unsigned(i(7 downto ratio_log2))));
+            when others =>
+                crtc_pixel <= crtc_word(23 downto 0);
+        end case;
+    end process;
+
+    crtc_r <= crtc_pixel(7 downto 0);
+    crtc_g <= crtc_pixel(15 downto 8);
+    crtc_b <= crtc_pixel(23 downto 16);
+
 end architecture synth;
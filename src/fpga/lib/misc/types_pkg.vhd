@@ -21,6 +21,7 @@ use ieee.std_logic_1164.all;
 package types_pkg is
 
     type slv_31_0_t is array(natural range <>) of std_logic_vector(31 downto 0);
+    type slv_15_0_t is array(natural range <>) of std_logic_vector(15 downto 0);
     type slv_9_0_t is array(natural range <>) of std_logic_vector(9 downto 0);
     type slv_7_0_t is array(natural range <>) of std_logic_vector(7 downto 0);
     type slv_3_0_t is array(natural range <>) of std_logic_vector(3 downto 0);
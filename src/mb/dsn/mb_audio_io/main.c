@@ -24,6 +24,7 @@
 #include "xil_printf.h"
 #include "axi_iic.h"
 #include "adau1761.h"
+#include "binlog.h"
 #endif
 #include "axi_fifo_mm.h"
 
@@ -50,6 +51,7 @@ int main()
     axi_iic_gpo(0x55);
 #ifndef BUILD_CONFIG_DEBUG
     adau1761_init();
+    binlog_init();
 
     i = 0;
 	peak.raw = 0;
@@ -73,11 +75,12 @@ int main()
 #ifndef BUILD_CONFIG_DEBUG
 		i = (i + 1) % 48000;
 		if (i == 0) {
-			xil_printf("%d %d\n\r", peak.frame.l, peak.frame.r);
+			BINLOG2("%d %d\n\r", peak.frame.l, peak.frame.r);
             peak.raw = 0;
 			gpo++;
 			axi_iic_gpo(gpo);
 		}
+		binlog_drain();
 #endif
 	}
 }
@@ -26,14 +26,14 @@ int main()
 	int i;
 	uint8_t attr;
 	unsigned int u;
-	char s[256];
+	char s[8];
 
 	vdu_init(MODE);
 	vdu_set_border(VDU_LIGHT_BLUE);
 	vdu_set_col(VDU_YELLOW, VDU_BLUE);
 	printf("MicroBlaze demo application for mb_display_sd design...\n");
 
-	strcpy(s, "HELLO! ");
+	snprintf(s, sizeof(s), "%s", "HELLO! ");
 	attr = 0x34;
 	u = (80*((MODE?32:25)-1))/strlen(s);
 	for (i = 0; i < u; i++) {
@@ -0,0 +1,279 @@
+/*******************************************************************************
+** bench.c                                                                    **
+** Rendering throughput benchmark for mb_fb design.                           **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#include <stdint.h>
+
+#include "fb.h"
+#include "fb_blit.h"
+#include "fb_glyph.h"
+#include "fb_raster.h"
+#include "font_437_8x16.h"
+#include "hagl.h"
+#include "font5x7.h"
+#include "bench.h"
+
+#ifdef FB_HOST
+#include <stdio.h>
+#include <time.h>
+#else
+#include "axi_timer.h"
+#include "axi_uartlite.h"
+#endif
+#include "printf.h"
+
+#define BENCH_HZ 100000000	// tick rate (CPU clock)
+#define BENCH_N 1000		// primitives per class
+#define BENCH_SEED 1
+#define BENCH_MIN 8			// shape sizes are uniform in MIN..MAX pixels
+#define BENCH_MAX 64
+#define BENCH_NUM_N 100000	// numbers per printf conversion
+#define BENCH_SPRITE 32		// sprite width and height (held in local memory)
+#define BENCH_KEY 0			// sprite key colour (also fully transparent)
+#define BENCH_BLIT 8		// first blit class
+
+// The same pseudo random sequence is used on the target and the host
+// (the C library rand() differs between the two).
+static uint32_t bench_seed;
+
+static uint32_t bench_rand()
+{
+	bench_seed ^= bench_seed << 13;
+	bench_seed ^= bench_seed >> 17;
+	bench_seed ^= bench_seed << 5;
+	return bench_seed;
+}
+
+static int16_t bench_range(int16_t min, int16_t max)
+{
+	return min + (bench_rand() % (max+1-min));
+}
+
+static uint32_t bench_ticks()
+{
+#ifdef FB_HOST
+	struct timespec t;
+
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return (t.tv_sec * BENCH_HZ) + (t.tv_nsec / (1000000000 / BENCH_HZ));
+#else
+	return axi_timer_get();
+#endif
+}
+
+#ifdef FB_HOST
+static void bench_putc(void *p, char c)
+{
+	putchar(c);
+}
+#endif
+
+static uint32_t bench_sprite_buf[BENCH_SPRITE*BENCH_SPRITE];
+static const fb_sprite_t bench_sprite = {
+	BENCH_SPRITE, BENCH_SPRITE, BENCH_SPRITE, bench_sprite_buf
+};
+
+// fills the sprite with random colours and alphas, a quarter of its pixels
+// being the key colour
+static void bench_sprite_init()
+{
+	uint16_t i;
+
+	bench_seed = BENCH_SEED;
+	for (i = 0; i < BENCH_SPRITE*BENCH_SPRITE; i++) {
+		bench_sprite_buf[i] = bench_rand();
+		if ((bench_sprite_buf[i] & 3) == 0)
+			bench_sprite_buf[i] = BENCH_KEY;
+	}
+}
+
+static int16_t abs16(int16_t a)
+{
+	return a < 0 ? -a : a;
+}
+
+// Draws BENCH_N primitives of class c, returning the number of pixels
+// drawn (nominal area for filled shapes). With FB_CACHED, the time taken
+// includes writing the drawing back to DDR.
+static uint32_t bench_class(uint8_t c)
+{
+	uint16_t i;
+	uint32_t p = 0;
+	int16_t s, x0, y0, x1, y1, x2, y2, a, b;
+	color_t k;
+
+	for (i = 0; i < BENCH_N; i++) {
+		s = bench_range(BENCH_MIN, BENCH_MAX);
+		x0 = bench_range(0, fb_width-1-s);
+		y0 = bench_range(0, fb_height-1-s);
+		k = bench_rand();
+		switch(c) {
+			case 0: // line, within an s x s box
+				x1 = bench_range(0, s);
+				y1 = bench_range(0, s);
+				hagl_draw_line(x0, y0, x0+x1, y0+y1, k);
+				p += (x1 > y1 ? x1 : y1) + 1;
+				break;
+			case 1: // filled rectangle, s x random height
+				y1 = bench_range(BENCH_MIN, s);
+				hagl_fill_rectangle(x0, y0, x0+s-1, y0+y1-1, k);
+				p += s * y1;
+				break;
+			case 2: // filled triangle, within an s x s box
+				x1 = bench_range(0, s);
+				y1 = bench_range(0, s);
+				x2 = bench_range(0, s);
+				y2 = bench_range(0, s);
+				hagl_fill_triangle(x0+(s>>1), y0, x0+x1, y0+y1, x0+x2, y0+y2, k);
+				p += abs16(((x1-(s>>1))*y2)-((x2-(s>>1))*y1)) >> 1;
+				break;
+			case 3: // filled ellipse, within an s x s box
+				a = s >> 1;
+				b = bench_range(BENCH_MIN >> 1, a);
+				hagl_fill_ellipse(x0+a, y0+a, a, b, k);
+				p += (a * b * 355) / 113;
+				break;
+			case 4: // filled triangle, as case 2, span rasteriser
+				x1 = bench_range(0, s);
+				y1 = bench_range(0, s);
+				x2 = bench_range(0, s);
+				y2 = bench_range(0, s);
+				fb_fill_triangle(x0+(s>>1), y0, x0+x1, y0+y1, x0+x2, y0+y2, k);
+				p += abs16(((x1-(s>>1))*y2)-((x2-(s>>1))*y1)) >> 1;
+				break;
+			case 5: // filled ellipse, as case 3, span rasteriser
+				a = s >> 1;
+				b = bench_range(BENCH_MIN >> 1, a);
+				fb_fill_ellipse(x0+a, y0+a, a, b, k);
+				p += (a * b * 355) / 113;
+				break;
+			case 6: // hagl character (font5x7)
+				hagl_put_char(32+(bench_rand() % 95), x0, y0, k, font5x7);
+				p += 5*7;
+				break;
+			case 7: // glyph cache character (CP437 8x16)
+				fb_glyph_put(x0, y0, bench_rand());
+				p += 8*16;
+				break;
+			default: // sprite, opaque, colour keyed or alpha blended
+				x0 = bench_range(0, fb_width-BENCH_SPRITE);
+				y0 = bench_range(0, fb_height-BENCH_SPRITE);
+				fb_blit(x0, y0, &bench_sprite, c-BENCH_BLIT, BENCH_KEY);
+				p += BENCH_SPRITE*BENCH_SPRITE;
+		}
+	}
+	fb_flush();
+	return p;
+}
+
+static const char *bench_num_name[] = {
+	"%u",
+	"%d",
+	"%x",
+#ifdef PRINTF_LONG_LONG_SUPPORT
+	"%llu",
+#endif
+};
+
+// Formats BENCH_NUM_N pseudo random numbers with tfp_snprintf() using
+// conversion c, returning the number of characters produced.
+static uint32_t bench_num(uint8_t c)
+{
+	char s[24];
+	uint32_t i, n = 0;
+
+	for (i = 0; i < BENCH_NUM_N; i++) {
+		switch(c) {
+			case 0:
+				n += snprintf(s, sizeof(s), "%u", bench_rand());
+				break;
+			case 1:
+				n += snprintf(s, sizeof(s), "%d", (int32_t)bench_rand());
+				break;
+			case 2:
+				n += snprintf(s, sizeof(s), "%x", bench_rand());
+				break;
+			default:
+				n += snprintf(s, sizeof(s), "%llu", (unsigned long long)(((uint64_t)bench_rand() << 32) | bench_rand()));
+		}
+	}
+	return n;
+}
+
+static const char *bench_name[] = {
+	"line",
+	"rectangle",
+	"triangle",
+	"ellipse",
+	"triangle *",
+	"ellipse *",
+	"char hagl",
+	"char cache",
+	"blit",
+	"blit key",
+	"blit alpha"
+};
+
+// Measures printf number formatting (numbers/second for each conversion),
+// then runs each class of primitive with a fixed seed in each display
+// mode, and reports primitives/second and kpixels/second. Classes marked
+// * use the span rasteriser (fb_raster.c) rather than hagl. The blit
+// classes (fb_blit.c) run only in 32 bpp format.
+void bench()
+{
+	uint8_t m, c;
+	uint32_t t, p;
+	fb_font_t f = { 8, 16, font_437_8x16 };
+
+#ifdef FB_HOST
+	init_printf(NULL, bench_putc);
+#else
+	init_printf(NULL, axi_uartlite_putc);
+	axi_timer_init();
+#endif
+	printf("format  numbers/s      chars/s\n");
+	for (c = 0; c < sizeof(bench_num_name)/sizeof(bench_num_name[0]); c++) {
+		bench_seed = BENCH_SEED;
+		t = bench_ticks();
+		p = bench_num(c);
+		t = bench_ticks()-t;
+		if (!t)
+			t = 1;
+		printf("%6s %10u %12u\n", bench_num_name[c],
+			(uint32_t)(((uint64_t)BENCH_NUM_N * BENCH_HZ) / t),
+			(uint32_t)(((uint64_t)p * BENCH_HZ) / t));
+	}
+	bench_sprite_init();
+	printf("mode      class   prims/s    kpixels/s\n");
+	for (m = FB_MODE_640x480p60; m <= FB_MODE_1920x1080p50; m++) {
+		fb_init_fmt(m, DISPLAY_FMT);
+		hagl_init();
+		fb_glyph_init(&f, 0xFFFFFF, 0);
+		for (c = 0; c < sizeof(bench_name)/sizeof(bench_name[0]); c++) {
+			if (c >= BENCH_BLIT && fb_fmt != FB_FMT_32BPP)
+				break;
+			bench_seed = BENCH_SEED;
+			t = bench_ticks();
+			p = bench_class(c);
+			t = bench_ticks()-t;
+			if (!t)
+				t = 1;
+			printf("%4d %10s %9u %12u\n", m, bench_name[c],
+				(uint32_t)(((uint64_t)BENCH_N * BENCH_HZ) / t),
+				(uint32_t)(((uint64_t)p * (BENCH_HZ / 1000)) / t));
+		}
+	}
+}
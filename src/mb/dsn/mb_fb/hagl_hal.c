@@ -4,15 +4,102 @@
 #include "hagl_hal.h"
 #include "hagl.h"
 #include "fb.h"
+#include "fb_blit.h"
+#include "fb_glyph.h"
+#include "fb_raster.h"
+#include "fontx.h"
 
 
 bitmap_t *hagl_hal_init(void)
 {
-	hagl_set_clip_window(0, 0, DISPLAY_WIDTH - 1, DISPLAY_HEIGHT -1);
+	hagl_hal_set_clip_window(0, 0, DISPLAY_WIDTH - 1, DISPLAY_HEIGHT -1);
 	return NULL;
 }
 
+// sets the hagl clip window, and the blitter and rasteriser clip windows
+// to match
+void hagl_hal_set_clip_window(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+	hagl_set_clip_window(x0, y0, x1, y1);
+	fb_blit_clip(x0, y0, x1, y1);
+	fb_raster_clip(x0, y0, x1, y1);
+}
+
+// describes a single byte hagl (FONTX2) font, up to 8 pixels wide, for
+// the glyph cache; returns 0 on success
+uint8_t hagl_hal_font(fb_font_t *f, const uint8_t *font)
+{
+	fontx_meta_t meta;
+	fontx_glyph_t glyph;
+
+	if (fontx_meta(&meta, font) || meta.type || meta.width > 8)
+		return 1;
+	if (fontx_glyph(&glyph, 0, font))
+		return 1;
+	f->width = meta.width;
+	f->height = meta.height;
+	f->bits = glyph.buffer;
+	return 0;
+}
+
+#define PIXEL_PTR(x,y) ((FB_VOLATILE color_t *)fb_row[y]+(x))
+
 void hagl_hal_put_pixel(int16_t x, int16_t y, color_t color)
 {
-	*(color_t *)(FB_BASE+(((y * fb_width) + x) << 2)) = color;
+	*PIXEL_PTR(x, y) = color;
+}
+
+// hagl clips lines and blits before calling the functions below, so
+// there are no bounds checks here
+
+void hagl_hal_hline(int16_t x0, int16_t y0, uint16_t width, color_t color)
+{
+	FB_VOLATILE color_t *p = PIXEL_PTR(x0, y0);
+	FB_VOLATILE uint32_t *p32;
+	uint32_t c;
+
+	if (sizeof(color_t) < 4) { // store whole words where possible
+		while (width && ((uintptr_t)p & 3)) {
+			*p++ = color;
+			width--;
+		}
+		c = (uint32_t)color * ((sizeof(color_t) == 1) ? 0x01010101 : 0x00010001);
+		p32 = (FB_VOLATILE uint32_t *)p;
+		for (; width >= 4/sizeof(color_t); width -= 4/sizeof(color_t))
+			*p32++ = c;
+		p = (FB_VOLATILE color_t *)p32;
+	}
+	for (; width >= 4; width -= 4) {
+		p[0] = color;
+		p[1] = color;
+		p[2] = color;
+		p[3] = color;
+		p += 4;
+	}
+	while (width--)
+		*p++ = color;
+}
+
+void hagl_hal_vline(int16_t x0, int16_t y0, uint16_t height, color_t color)
+{
+	FB_VOLATILE color_t *p = PIXEL_PTR(x0, y0);
+
+	while (height--) {
+		*p = color;
+		p += fb_pitch;
+	}
+}
+
+void hagl_hal_blit(uint16_t x0, uint16_t y0, bitmap_t *src)
+{
+	FB_VOLATILE color_t *p = PIXEL_PTR(x0, y0);
+	color_t *s;
+	uint16_t x, y;
+
+	for (y = 0; y < src->height; y++) {
+		s = (color_t *)(src->buffer + (y * src->pitch));
+		for (x = 0; x < src->width; x++)
+			p[x] = s[x];
+		p += fb_pitch;
+	}
 }
@@ -1,13 +1,35 @@
 #include <stdint.h>
 #include "fb.h"
+#include "bitmap.h"
+#include "fb_glyph.h"
 
 #define HAGL_HAS_HAL_INIT
 #define HAGL_HAS_HAL_VARIABLE_DISPLAY_SIZE
+#define HAGL_HAS_HAL_HLINE
+#define HAGL_HAS_HAL_VLINE
+#define HAGL_HAS_HAL_BLIT
 
+// DISPLAY_DEPTH may be 32, 16 (RGB565) or 8 (palette index)
+#ifndef DISPLAY_DEPTH
 #define DISPLAY_DEPTH (32)
+#endif
 #define DISPLAY_WIDTH fb_width
 #define DISPLAY_HEIGHT fb_height
 
+#if DISPLAY_DEPTH == 8
+#define DISPLAY_FMT FB_FMT_8BPP
+typedef uint8_t color_t;
+#elif DISPLAY_DEPTH == 16
+#define DISPLAY_FMT FB_FMT_16BPP
+typedef uint16_t color_t;
+#else
+#define DISPLAY_FMT FB_FMT_32BPP
 typedef uint32_t color_t;
+#endif
 
+uint8_t hagl_hal_font(fb_font_t *f, const uint8_t *font);
+void hagl_hal_set_clip_window(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
 void hagl_hal_put_pixel(int16_t x, int16_t y, color_t color);
+void hagl_hal_hline(int16_t x0, int16_t y0, uint16_t width, color_t color);
+void hagl_hal_vline(int16_t x0, int16_t y0, uint16_t height, color_t color);
+void hagl_hal_blit(uint16_t x0, uint16_t y0, bitmap_t *src);
@@ -0,0 +1,69 @@
+################################################################################
+## host.mk                                                                    ##
+## Host (Linux) build of the mb_fb demo, rendering to a PPM file.             ##
+################################################################################
+## (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        ##
+## This file is part of The Tyto Project. The Tyto Project is free software:  ##
+## you can redistribute it and/or modify it under the terms of the GNU Lesser ##
+## General Public License as published by the Free Software Foundation,       ##
+## either version 3 of the License, or (at your option) any later version.    ##
+## The Tyto Project is distributed in the hope that it will be useful, but    ##
+## WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY ##
+## or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     ##
+## License for more details. You should have received a copy of the GNU       ##
+## Lesser General Public License along with The Tyto Project. If not, see     ##
+## https://www.gnu.org/licenses/.                                             ##
+################################################################################
+
+# usage (from this directory):
+#   make -f host.mk [DISPLAY_DEPTH=32|16|8]
+#   ./mb_fb_host     (writes mb_fb.ppm)
+#   make -f host.mk mb_fb_bench
+#   ./mb_fb_bench    (runs the printf and rendering benchmarks - see bench.c)
+#   make -f host.mk mb_fb_vdu
+#   ./mb_fb_vdu      (text console demo and check, writes mb_fb.ppm - see vdu_demo.c)
+
+LIB = ../../lib
+HAGL = ../../../../submodules/hagl
+DISPLAY_DEPTH ?= 32
+
+CC = gcc
+CFLAGS = -O2 -Wall -DFB_HOST -DDISPLAY_DEPTH=$(DISPLAY_DEPTH) -I. -I$(LIB) -I$(HAGL)/include
+
+SRC = \
+	main.c \
+	bench.c \
+	vdu_demo.c \
+	hagl_hal.c \
+	$(LIB)/fb.c \
+	$(LIB)/fb_tile.c \
+	$(LIB)/fb_blit.c \
+	$(LIB)/fb_glyph.c \
+	$(LIB)/fb_raster.c \
+	$(LIB)/fb_qoi.c \
+	$(LIB)/fb_copy.c \
+	$(LIB)/font_437_8x16.c \
+	$(LIB)/printf.c \
+	$(LIB)/vdu_term.c \
+	$(LIB)/fb_vdu.c \
+	$(HAGL)/src/bitmap.c \
+	$(HAGL)/src/clip.c \
+	$(HAGL)/src/fontx.c \
+	$(HAGL)/src/hagl.c \
+	$(HAGL)/src/hsl.c \
+	$(HAGL)/src/rgb888.c \
+	$(HAGL)/src/rgb565.c
+
+mb_fb_host: $(SRC)
+	$(CC) $(CFLAGS) -o $@ $(SRC)
+
+mb_fb_bench: $(SRC)
+	$(CC) $(CFLAGS) -DFB_BENCH -o $@ $(SRC)
+
+mb_fb_vdu: $(SRC)
+	$(CC) $(CFLAGS) -DFB_VDU -o $@ $(SRC)
+
+clean:
+	rm -f mb_fb_host mb_fb_bench mb_fb_vdu mb_fb.ppm
+
+.PHONY: clean
@@ -20,15 +20,30 @@
 
 #include "fb.h"
 #include "hagl.h"
+#include "fb_raster.h"
 #include "font5x7.h"
+#include "font_437_8x16.h"
+#ifdef FB_BENCH
+#include "bench.h"
+#endif
+#ifdef FB_VDU
+#include "vdu_demo.h"
+#endif
 
 int main()
 {
+#ifdef FB_BENCH
+	bench();
+#elif defined(FB_VDU)
+	if (vdu_demo())
+		return 1;
+#else
 	int i;
 	uint16_t w,h, a, b, x[3], y[3];
 	color_t c;
+	fb_font_t f;
 
-	fb_init(FB_MODE_640x480p60);
+	fb_init_fmt(FB_MODE_640x480p60, DISPLAY_FMT);
 	hagl_init();
 
 	w = DISPLAY_WIDTH;
@@ -46,7 +61,7 @@ int main()
 			case 1: // triangle
 			    x[2] = rand() % DISPLAY_WIDTH;
 			    y[2] = rand() % DISPLAY_HEIGHT;
-				hagl_fill_triangle(x[0], y[0], x[1], y[1], x[2], y[2], c);
+				fb_fill_triangle(x[0], y[0], x[1], y[1], x[2], y[2], c);
 				break;
 			case 2: // rectangle
 				hagl_fill_rectangle(x[0], y[0], x[1], y[1], c);
@@ -56,7 +71,7 @@ int main()
 				y[2] = (y[0]+y[1]) >> 1;
 				a = abs(x[0]-x[1]) >> 1;
 				b = abs(y[0]-y[1]) >> 1;
-				hagl_fill_ellipse(x[2], y[2], a, b, c);
+				fb_fill_ellipse(x[2], y[2], a, b, c);
 				break;
 		}
 	}
@@ -67,8 +82,21 @@ int main()
 	hagl_draw_rectangle(	0,		h/2,	w/2-1,		h-1,	c	);
 	hagl_draw_rectangle(	w/2,	h/2,	w-1,		h-1,	c	);
 
-	hagl_put_text(L"hello world!", 0, 0, 0xFFFFFF, font5x7);
+	hagl_hal_font(&f, font5x7);
+	fb_glyph_init(&f, 0xFFFFFF, 0);
+	fb_glyph_puts(0, 0, "hello world!");
+	f.width = 8;
+	f.height = 16;
+	f.bits = font_437_8x16;
+	fb_glyph_init(&f, 0xFFFFFF, 0);
+	fb_glyph_puts(0, 8, "hello world!");
+	fb_flush();
+#endif
 
+#ifdef FB_HOST
+	return fb_snapshot("mb_fb.ppm");
+#else
 	while(1)
 		;
+#endif
 }
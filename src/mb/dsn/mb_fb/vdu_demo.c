@@ -0,0 +1,84 @@
+/*******************************************************************************
+** vdu_demo.c                                                                 **
+** Text console demo for mb_fb design.                                        **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+#ifdef FB_HOST
+#include <stdio.h>
+#include <stdlib.h>
+#endif
+
+#include "fb.h"
+#include "printf.h"
+#include "vdu.h"
+
+#define VDU_DEMO_MODE FB_MODE_1280x720p60	// 160 x 45 characters
+
+// Exercises the frame buffer console (fb_vdu.c): colours and reverse video
+// set by escape sequences, the CP437 character set, rectangle operations,
+// and scrolling within a scroll region. On the host, the screen drawn
+// piece by piece is then checked against a full redraw from the console's
+// character buffer (vdu_show()), and 0 is returned if they match.
+int vdu_demo()
+{
+	uint16_t i;
+	uint8_t c;
+#ifdef FB_HOST
+	uint8_t *p;
+	uint32_t n, e;
+	int16_t y;
+#endif
+
+	vdu_init(VDU_DEMO_MODE);
+	printf("\x1b[1;33mmb_fb text console\x1b[0m (fb_vdu.c, vdu.h API)\n\n");
+
+	// foreground and background colours, then reverse video
+	for (c = 0; c < 8; c++)
+		printf("\x1b[3%d;40m fg %d \x1b[1m bright \x1b[0m", c, c);
+	printf("\n");
+	for (c = 0; c < 8; c++)
+		printf("\x1b[30;4%dm bg %d \x1b[0m", c, c);
+	printf("\n\x1b[7m reverse \x1b[7m still reverse \x1b[27m normal\n\n");
+
+	// character set
+	for (i = 0; i < 256; i++)
+		vdu_poke_char_attr(2+(i & 63), 7+(i >> 6), i, 0x1F);
+	vdu_fill_rect(70, 7, 20, 4, 0xB1, 0x2A);
+	vdu_recol_rect(75, 8, 10, 2, 0x4E);
+
+	// scrolling: a 10 line region, and 200 lines through it
+	vdu_set_pos(0, 12);
+	printf("\x1b[14;23r\x1b[23;1H");
+	for (i = 0; i < 200; i++)
+		printf("\x1b[3%dmline %3d: the quick brown fox jumps over the lazy dog\n", 1+(i % 7), i);
+	printf("\x1b[r\x1b[0m\x1b[25;1Hdone\n");
+
+#ifdef FB_HOST
+	n = (uint32_t)fb_pitch << (2-fb_fmt); // bytes per row
+	p = malloc(n*fb_height);
+	for (y = 0; y < fb_height; y++)
+		memcpy(p+(y*n), (void *)fb_row[y], n);
+	vdu_show(vdu_get_shown());
+	for (e = 0, y = 0; y < fb_height; y++)
+		e += memcmp(p+(y*n), (void *)fb_row[y], n) != 0;
+	free(p);
+	fprintf(stderr, "vdu_demo: %u rows differ from a full redraw\n", e);
+	return e != 0;
+#else
+	return 0;
+#endif
+}
@@ -0,0 +1,36 @@
+/*******************************************************************************
+** axi_timer.c                                                                **
+** Simple driver for AXI Timer IP core.                                       **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#include <stdint.h>
+#include "peekpoke.h"
+#include "axi_timer_p.h"
+
+// starts timer 0 counting up from zero, free running (wraps after 2^32
+// clocks - about 43 seconds at 100MHz)
+void axi_timer_init()
+{
+    poke32(BASE+REG_TCSR0,0);
+    poke32(BASE+REG_TLR0,0);
+    poke32(BASE+REG_TCSR0,TCSR_LOAD);
+    poke32(BASE+REG_TCSR0,TCSR_ENT|TCSR_ARHT);
+}
+
+// returns count of CPU clocks
+uint32_t axi_timer_get()
+{
+    return peek32(BASE+REG_TCR0);
+}
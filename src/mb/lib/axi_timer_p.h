@@ -0,0 +1,36 @@
+/*******************************************************************************
+** axi_timer_p.h                                                              **
+** Simple driver for AXI Timer IP core.                                       **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#ifndef _AXI_TIMER_P_H_
+#define _AXI_TIMER_P_H_
+
+#include "xparameters.h"
+
+#define BASE XPAR_TIMER_BASEADDR
+
+#define REG_TCSR0       0x0000 // Timer 0 Control and Status Register
+#define REG_TLR0        0x0004 // Timer 0 Load Register
+#define REG_TCR0        0x0008 // Timer 0 Counter Register
+#define REG_TCSR1       0x0010 // Timer 1 Control and Status Register
+#define REG_TLR1        0x0014 // Timer 1 Load Register
+#define REG_TCR1        0x0018 // Timer 1 Counter Register
+
+#define TCSR_ARHT       (1<<4) // auto reload/hold
+#define TCSR_LOAD       (1<<5) // load timer from load register
+#define TCSR_ENT        (1<<7) // enable timer
+
+#endif
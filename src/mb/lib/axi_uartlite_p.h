@@ -0,0 +1,33 @@
+/*******************************************************************************
+** axi_uartlite_p.h                                                           **
+** Simple driver for AXI UART Lite IP core.                                   **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#ifndef _AXI_UARTLITE_P_H_
+#define _AXI_UARTLITE_P_H_
+
+#include "xparameters.h"
+
+#define BASE XPAR_UART_BASEADDR
+
+#define REG_RX          0x0000 // Receive Data FIFO
+#define REG_TX          0x0004 // Transmit Data FIFO
+#define REG_STAT        0x0008 // Status Register
+#define REG_CTRL        0x000C // Control Register
+
+#define STAT_RX_VALID   (1<<0)
+#define STAT_TX_FULL    (1<<3)
+
+#endif
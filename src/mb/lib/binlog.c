@@ -0,0 +1,93 @@
+/*******************************************************************************
+** binlog.c                                                                   **
+** Deferred binary logging to AXI UART Lite.                                  **
+********************************************************************************
+** (C) Copyright 2020 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#include <stdint.h>
+
+#include "xparameters.h"
+
+#include "peekpoke.h"
+#include "binlog.h"
+#include "binlog_p.h"
+
+// Records are written to a RAM ring by binlog_put (a handful of stores,
+// no formatting) and sent to the UART by binlog_drain, a few bytes at a
+// time, without ever waiting. Formatting is done on the host by binlog.py
+// using the format strings in the ELF file.
+// There must be one producer: binlog_put is not reentrant, so records may
+// be logged from main code or from an interrupt handler, but not both.
+// binlog_drain may run in the other context.
+
+static volatile uint32_t ring[BINLOG_SIZE];	// volatile: stores complete before wr is published
+static volatile uint32_t wr;		// write index (free running)
+static volatile uint32_t rd;		// read index (free running)
+static uint32_t dropped;			// records dropped since last record
+static uint32_t tx_word;			// word being sent
+static uint8_t tx_bytes;			// bytes of tx_word still to send
+
+void binlog_init()
+{
+	wr = 0;
+	rd = 0;
+	dropped = 0;
+	tx_bytes = 0;
+}
+
+void binlog_put(const char *fmt, uint32_t n, uint32_t a, uint32_t b, uint32_t c, uint32_t d)
+{
+	uint32_t w = wr;
+
+	if (BINLOG_SIZE - (w - rd) < n+2) {
+		dropped++;
+		return;
+	}
+	ring[w & MASK] = (BINLOG_SYNC << 24) | (n << 16) | (dropped > 0xFFFF ? 0xFFFF : dropped);
+	ring[(w+1) & MASK] = (uint32_t)(uintptr_t)fmt;
+	switch(n) {
+		case 4: ring[(w+5) & MASK] = d;
+			/* fall through */
+		case 3: ring[(w+4) & MASK] = c;
+			/* fall through */
+		case 2: ring[(w+3) & MASK] = b;
+			/* fall through */
+		case 1: ring[(w+2) & MASK] = a;
+	}
+	dropped = 0;
+	wr = w+n+2;
+}
+
+// sends as many bytes as the UART TX FIFO will take, then returns
+void binlog_drain()
+{
+	while (!(peek32(BASE+REG_STAT) & STAT_TX_FULL)) {
+		if (!tx_bytes) {
+			if (rd == wr)
+				break;
+			tx_word = ring[rd & MASK];
+			rd++;
+			tx_bytes = 4;
+		}
+		poke32(BASE+REG_TX,tx_word & 0xFF);
+		tx_word >>= 8;
+		tx_bytes--;
+	}
+}
+
+// returns number of words waiting to be sent
+uint32_t binlog_pending()
+{
+	return wr - rd;
+}
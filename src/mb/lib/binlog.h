@@ -0,0 +1,46 @@
+/*******************************************************************************
+** binlog.h                                                                   **
+** Deferred binary logging to AXI UART Lite.                                  **
+********************************************************************************
+** (C) Copyright 2020 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#ifndef _BINLOG_H_
+#define _BINLOG_H_
+
+#include "stdint.h"
+
+// ring buffer size in 32 bit words (must be a power of 2)
+#ifndef BINLOG_SIZE
+#define BINLOG_SIZE 256
+#endif
+
+// each record on the wire is a sequence of little endian 32 bit words:
+//  header:  bits 31:24 = BINLOG_SYNC, 23:16 = argument count (0..4),
+//           15:0 = records dropped (ring full) since the previous record
+//  format:  address of format string in the ELF image
+//  args:    0 to 4 raw argument words
+#define BINLOG_SYNC 0xB1
+
+#define BINLOG0(f)           binlog_put(f,0,0,0,0,0)
+#define BINLOG1(f,a)         binlog_put(f,1,(uint32_t)(a),0,0,0)
+#define BINLOG2(f,a,b)       binlog_put(f,2,(uint32_t)(a),(uint32_t)(b),0,0)
+#define BINLOG3(f,a,b,c)     binlog_put(f,3,(uint32_t)(a),(uint32_t)(b),(uint32_t)(c),0)
+#define BINLOG4(f,a,b,c,d)   binlog_put(f,4,(uint32_t)(a),(uint32_t)(b),(uint32_t)(c),(uint32_t)(d))
+
+void binlog_init();
+void binlog_put(const char *fmt, uint32_t n, uint32_t a, uint32_t b, uint32_t c, uint32_t d);
+void binlog_drain();
+uint32_t binlog_pending();
+
+#endif
@@ -0,0 +1,149 @@
+################################################################################
+## binlog.py                                                                  ##
+## Decodes binary log records (see binlog.h) using format strings from ELF.   ##
+################################################################################
+## (C) Copyright 2020 Adam Barnes <ambarnes@gmail.com>                        ##
+## This file is part of The Tyto Project. The Tyto Project is free software:  ##
+## you can redistribute it and/or modify it under the terms of the GNU Lesser ##
+## General Public License as published by the Free Software Foundation,       ##
+## either version 3 of the License, or (at your option) any later version.    ##
+## The Tyto Project is distributed in the hope that it will be useful, but    ##
+## WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY ##
+## or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     ##
+## License for more details. You should have received a copy of the GNU       ##
+## Lesser General Public License along with The Tyto Project. If not, see     ##
+## https://www.gnu.org/licenses/.                                             ##
+################################################################################
+
+import sys
+import struct
+
+BINLOG_SYNC = 0xB1
+
+# returns list of (address, data) for allocated sections of an ELF32 file
+def elf_sections(filename):
+    with open(filename, 'rb') as f:
+        elf = f.read()
+    if elf[0:4] != b'\x7fELF' or elf[4] != 1:
+        print('error: '+filename+': not an ELF32 file')
+        sys.exit(1)
+    e = '<' if elf[5] == 1 else '>'
+    shoff, = struct.unpack(e+'I', elf[32:36])
+    shentsize, shnum = struct.unpack(e+'HH', elf[46:50])
+    r = []
+    for i in range(shnum):
+        sh = elf[shoff+i*shentsize:shoff+(i+1)*shentsize]
+        sh_type, sh_flags, sh_addr, sh_offset, sh_size = struct.unpack(e+'IIIII', sh[4:24])
+        if sh_type == 1 and sh_flags & 2: # SHT_PROGBITS, SHF_ALLOC
+            r.append((sh_addr, elf[sh_offset:sh_offset+sh_size]))
+    return r
+
+def get_string(addr):
+    for a, d in sections:
+        if a <= addr < a+len(d):
+            d = d[addr-a:]
+            return d[:d.index(b'\0')].decode('latin-1')
+    return '<bad string address 0x%08X>' % addr
+
+# formats a record the way printf.c would
+def format_record(fmt, args):
+    r = ''
+    i = 0
+    while i < len(fmt):
+        ch = fmt[i]
+        i += 1
+        if ch != '%':
+            r += ch
+            continue
+        spec = '%'
+        while i < len(fmt) and fmt[i] in '0123456789':
+            spec += fmt[i]
+            i += 1
+        prec = -1
+        if i < len(fmt) and fmt[i] == '.':
+            i += 1
+            prec = 0
+            while i < len(fmt) and fmt[i] in '0123456789':
+                prec = prec*10+int(fmt[i])
+                i += 1
+        sht = False
+        if i < len(fmt) and fmt[i] == 'h':
+            sht = True
+            i += 1
+        lng = 0
+        while i < len(fmt) and fmt[i] == 'l':
+            lng += 1
+            i += 1
+        if i >= len(fmt):
+            break
+        ch = fmt[i]
+        i += 1
+        if ch == '%':
+            r += '%'
+            continue
+        if not args:
+            r += '<missing argument>'
+            continue
+        v = args.pop(0)
+        if lng == 2 and args:
+            v |= args.pop(0) << 32
+            bits = 64
+        else:
+            bits = 32
+        if ch == 'd':
+            if v & (1 << (bits-1)):
+                v -= 1 << bits
+            r += (spec+'d') % v
+        elif ch in 'uxX':
+            r += (spec+ch) % v
+        elif ch == 'q':
+            fb = 15 if sht else 16
+            if sht:
+                v &= 0xFFFF
+                bits = 16
+            if v & (1 << (bits-1)):
+                v -= 1 << bits
+            prec = 4 if prec < 0 else min(prec, 9)
+            m = (abs(v)*(10**prec)*2+(1 << fb)) >> (fb+1) # round half up
+            q = str(m // 10**prec)
+            if prec:
+                q += '.'+str(m % 10**prec).zfill(prec)
+            w = int(spec[1:] or '0')
+            if spec[1:2] == '0': # sign goes before zero padding
+                r += ('-' if v < 0 else '')+q.zfill(w-(v < 0))
+            else:
+                r += (('-' if v < 0 else '')+q).rjust(w)
+        elif ch == 'c':
+            r += chr(v & 0xFF)
+        elif ch == 's':
+            r += (spec.replace('%0', '%')+'s') % get_string(v)
+    return r
+
+if len(sys.argv) < 2 or len(sys.argv) > 3:
+    print('usage: binlog.py filename.elf [log]')
+    print('  filename.elf = ELF file of the application that wrote the log')
+    print('  log = captured UART output or serial device (default: stdin)')
+    sys.exit(1)
+
+sections = elf_sections(sys.argv[1])
+log = open(sys.argv[2], 'rb', buffering=0) if len(sys.argv) == 3 else sys.stdin.buffer
+buf = bytearray()
+while True:
+    b = log.read(64)
+    if not b:
+        break
+    buf += b
+    while len(buf) >= 8:
+        hdr, = struct.unpack('<I', buf[0:4])
+        n = (hdr >> 16) & 0xFF
+        if hdr >> 24 != BINLOG_SYNC or n > 4: # resynchronise
+            del buf[0]
+            continue
+        if len(buf) < 8+4*n:
+            break
+        words = list(struct.unpack('<%dI' % (n+2), buf[0:8+4*n]))
+        del buf[0:8+4*n]
+        if hdr & 0xFFFF:
+            sys.stdout.write('<%d records dropped>\n' % (hdr & 0xFFFF))
+        sys.stdout.write(format_record(get_string(words[1]), words[2:]))
+        sys.stdout.flush()
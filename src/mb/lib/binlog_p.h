@@ -0,0 +1,32 @@
+/*******************************************************************************
+** binlog_p.h                                                                 **
+** Deferred binary logging to AXI UART Lite - private header.                 **
+********************************************************************************
+** (C) Copyright 2020 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#ifndef _BINLOG_P_H_
+#define _BINLOG_P_H_
+
+#define BASE XPAR_UART_BASEADDR
+
+#define REG_RX   0x00
+#define REG_TX   0x04
+#define REG_STAT 0x08
+#define REG_CTRL 0x0C
+
+#define STAT_TX_FULL  (1<<3)
+
+#define MASK (BINLOG_SIZE-1)
+
+#endif
@@ -16,11 +16,21 @@
 *******************************************************************************/
 
 #include <stdint.h>
+#include <stdlib.h>
 
 #include "peekpoke.h"
-#include "axi_gpio.h"
 #include "fb.h"
 
+uint8_t fb_mode;
+uint8_t fb_fmt;
+uint8_t fb_scale;
+int16_t fb_width;
+int16_t fb_height;
+int16_t fb_pitch;
+uint8_t fb_page;
+uintptr_t fb_base;
+uintptr_t fb_row[FB_MAX_HEIGHT];
+
 typedef struct {
 	uint16_t width;
 	uint16_t height;
@@ -44,18 +54,309 @@ const fb_dim_t fb_dims[] = {
 		{1920, 1080}
 };
 
+#define GPO_MODE 0x0F
+#define GPO_PAGE (1 << 4)
+#define GPO_FMT_SHIFT 5
+#define GPO_SCALE_SHIFT 7
+#define GPI_PAGE (1 << 4)
+#define GPI_VBLANK (1 << 5)
+#define GPI_VS (1 << 6)
+#define GPI_AY_SHIFT 16 // 12 bits, signed
+
+static uint32_t fb_gpo; // GPIO outputs (reading GPIO data returns inputs)
+
+#ifdef FB_HOST
+#include <stdio.h>
+// host build: the displayed page follows the page select output at once,
+// and the beam moves on a line each time the inputs are read
+#define FB_HOST_SIZE ((2*FB_PAGE_SIZE)+1024+FB_SPARE_SIZE) // 2 pages, palette and spare
+#define FB_HOST_VBLANK 45 // lines
+uint8_t *fb_host_mem;
+static uint32_t fb_host_gpo;
+static int16_t fb_host_line;
+#define fb_set_gpo(d) (fb_host_gpo = (d))
+static uint32_t fb_get_gpi()
+{
+	if (++fb_host_line >= (fb_height << fb_scale)+FB_HOST_VBLANK)
+		fb_host_line = 0;
+	return (fb_host_gpo & GPI_PAGE)
+		| (fb_host_line >= (fb_height << fb_scale) ? GPI_VBLANK : 0)
+		| ((uint32_t)fb_host_line << GPI_AY_SHIFT);
+}
+#else
+#include "axi_gpio.h"
+#define fb_set_gpo(d) axi_gpio_set_gpo(0, (d))
+#define fb_get_gpi() axi_gpio_get_gpi(0)
+#ifdef FB_CACHED
+#include "xil_cache.h"
+#endif
+#endif
+
+// data cache geometry (see C_DCACHE_BYTE_SIZE and C_DCACHE_LINE_LEN)
+#ifndef XPAR_MICROBLAZE_DCACHE_BYTE_SIZE
+#define XPAR_MICROBLAZE_DCACHE_BYTE_SIZE 8192
+#endif
+#ifndef XPAR_MICROBLAZE_DCACHE_LINE_LEN
+#define XPAR_MICROBLAZE_DCACHE_LINE_LEN 8
+#endif
+#define DCACHE_SIZE XPAR_MICROBLAZE_DCACHE_BYTE_SIZE
+#define DCACHE_LINE (XPAR_MICROBLAZE_DCACHE_LINE_LEN << 2) // bytes
+
+// the CRTC fetches lines in chunks of 64 pixels
+#define PITCH_ALIGN 64
+
+static void fb_set_rows()
+{
+	uint16_t y;
+	uintptr_t a = fb_base;
+
+	for (y = 0; y < fb_height; y++) {
+		fb_row[y] = a;
+		a += fb_pitch << (2-fb_fmt);
+	}
+}
+
 void fb_init(uint8_t mode)
 {
-	uint32_t a, r;
+	fb_init_fmt(mode, FB_FMT_32BPP);
+}
+
+void fb_init_fmt(uint8_t mode, uint8_t fmt)
+{
+	fb_init_scale(mode, fmt, FB_SCALE_1X);
+}
+
+// the frame buffer is cleared unless FB_INIT_RANDOM is defined, in which
+// case it is filled with random pixels (slow, but useful for testing)
+// in 8 bpp format, the palette is initialised to RGB332
+// fb_width and fb_height are the display size divided by the replication
+// factor (e.g. 480x270 for FB_MODE_1920x1080p60 and FB_SCALE_4X)
+void fb_init_scale(uint8_t mode, uint8_t fmt, uint8_t scale)
+{
+	uint16_t i;
+#ifdef FB_INIT_RANDOM
+	uintptr_t a;
 	uint32_t fb_size;
+#endif
 
 	fb_mode = mode;
-	fb_width = fb_dims[mode].width;
-	fb_height = fb_dims[mode].height;
-	fb_size = (fb_width * fb_height) << 2;
-	r = axi_gpio_get_gpo(0);
-	r = (r & ~0x0F) | (mode & 0x0F);
-	axi_gpio_set_gpo(0, r);
-	for (a = FB_BASE; a < FB_BASE+fb_size; a+=4)
+	fb_fmt = fmt;
+	fb_scale = scale;
+	fb_width = fb_dims[mode].width >> scale;
+	fb_height = fb_dims[mode].height >> scale;
+	fb_pitch = (fb_width+PITCH_ALIGN-1) & ~(PITCH_ALIGN-1);
+	fb_gpo = (mode & GPO_MODE) | (fmt << GPO_FMT_SHIFT) | (scale << GPO_SCALE_SHIFT);
+#ifdef FB_HOST
+	if (!fb_host_mem && !(fb_host_mem = calloc(FB_HOST_SIZE, 1)))
+		abort();
+#endif
+	fb_set_gpo(fb_gpo);
+	fb_page = 0;
+	fb_base = FB_BASE;
+	fb_set_rows();
+	if (fmt == FB_FMT_8BPP)
+		for (i = 0; i < 256; i++)
+			fb_set_pal(i, ((i >> 5) * 0x24) | (((i >> 2) & 7) * 0x2400) | ((i & 3) * 0x550000));
+#ifdef FB_INIT_RANDOM
+	fb_size = (fb_pitch * fb_height) << (2-fmt);
+	for (a = fb_base; a < fb_base+fb_size; a+=4)
 		poke32(a, rand());
+	fb_flush();
+#else
+	fb_clear();
+#endif
 }
+
+// sets palette entry i to colour c (32 bpp format); takes effect at the
+// next vertical sync
+void fb_set_pal(uint8_t i, uint32_t c)
+{
+	poke32(FB_PAL_BASE+(i << 2), c);
+	fb_flush_range(FB_PAL_BASE+(i << 2), 4);
+}
+
+// converts colour c (24 bit, byte 0 = red) to a pixel value in the current
+// format; at 8 bpp, this is an index into the RGB332 palette set up by
+// fb_init_fmt()
+uint32_t fb_rgb(uint32_t c)
+{
+	switch(fb_fmt) {
+		case FB_FMT_16BPP:
+			return ((c & 0xF8) << 8) | ((c >> 5) & 0x07E0) | ((c >> 19) & 0x1F);
+		case FB_FMT_8BPP:
+			return (c & 0xE0) | ((c >> 11) & 0x1C) | ((c >> 22) & 0x03);
+		default:
+			return c & 0xFFFFFF;
+	}
+}
+
+// fills the page being drawn with colour c (in the current pixel format)
+void fb_fill(uint32_t c)
+{
+	FB_VOLATILE uint32_t *p = (uint32_t *)fb_base;
+	uint32_t n = (fb_pitch * fb_height) >> fb_fmt;
+
+	if (fb_fmt == FB_FMT_16BPP)
+		c = (c & 0xFFFF) * 0x00010001;
+	else if (fb_fmt == FB_FMT_8BPP)
+		c = (c & 0xFF) * 0x01010101;
+	for (; n >= 8; n -= 8) {
+		p[0] = c;
+		p[1] = c;
+		p[2] = c;
+		p[3] = c;
+		p[4] = c;
+		p[5] = c;
+		p[6] = c;
+		p[7] = c;
+		p += 8;
+	}
+	while (n--)
+		*p++ = c;
+	fb_flush();
+}
+
+void fb_clear()
+{
+	fb_fill(0);
+}
+
+// Writes back any drawing in the data cache for the n bytes from address
+// a (the lines are also invalidated). Only dirty lines cause DDR writes. Does
+// nothing unless FB_CACHED is defined.
+void fb_flush_range(uintptr_t a, uint32_t n)
+{
+#if defined(FB_CACHED) && !defined(FB_HOST)
+	if (n >= DCACHE_SIZE)
+		Xil_DCacheFlush(); // cheaper to visit every line once
+	else if (n)
+		Xil_DCacheFlushRange(a, n);
+#endif
+}
+
+// Writes back any drawing in the data cache for the given rectangle of
+// the page being drawn (clipped to the screen).
+void fb_flush_rect(int16_t x, int16_t y, int16_t w, int16_t h)
+{
+#if defined(FB_CACHED) && !defined(FB_HOST)
+	uint32_t n;
+
+	if (x < 0) {
+		w += x;
+		x = 0;
+	}
+	if (y < 0) {
+		h += y;
+		y = 0;
+	}
+	if (x+w > fb_width)
+		w = fb_width-x;
+	if (y+h > fb_height)
+		h = fb_height-y;
+	if (w <= 0 || h <= 0)
+		return;
+	n = (w << 2) >> fb_fmt; // bytes per row
+	if ((uint32_t)h * ((n / DCACHE_LINE) + 2) >= DCACHE_SIZE / DCACHE_LINE) {
+		Xil_DCacheFlush(); // more lines to visit than are in the cache
+		return;
+	}
+	for (; h; h--, y++)
+		Xil_DCacheFlushRange(fb_row[y] + ((x << 2) >> fb_fmt), n);
+#endif
+}
+
+// Writes back all drawing in the data cache.
+void fb_flush()
+{
+#if defined(FB_CACHED) && !defined(FB_HOST)
+	Xil_DCacheFlush();
+#endif
+}
+
+// Displays the page being drawn, waiting for the CRTC to switch to it at
+// the next vertical sync, then switches drawing to the other page.
+// Initially the same page is displayed and drawn, so nothing changes
+// for applications that do not call this.
+void fb_swap()
+{
+	fb_flush();
+	if (fb_page)
+		fb_gpo |= GPO_PAGE;
+	else
+		fb_gpo &= ~GPO_PAGE;
+	fb_set_gpo(fb_gpo);
+	while (((fb_get_gpi() & GPI_PAGE) ? 1 : 0) != fb_page)
+		;
+	fb_page ^= 1;
+	fb_base = FB_BASE + (fb_page ? FB_PAGE_SIZE : 0);
+	fb_set_rows();
+}
+
+// Waits for the start of the next vertical blanking interval.
+void fb_wait_vblank()
+{
+	while (fb_get_gpi() & GPI_VBLANK)
+		;
+	while (!(fb_get_gpi() & GPI_VBLANK))
+		;
+}
+
+// Returns 1 during vertical blanking.
+uint8_t fb_in_vblank()
+{
+	return (fb_get_gpi() & GPI_VBLANK) ? 1 : 0;
+}
+
+// Returns the scanline being displayed: 0 to fb_height-1 in the active
+// area, negative from vertical sync to the first active line, and
+// fb_height or more after the last. In interlaced modes, this is the
+// frame line (field 2 shows the odd lines). With replication, this is the
+// frame buffer row. Note that the CRTC fetches pixels a little ahead of
+// display.
+int16_t fb_get_scanline()
+{
+	return (int32_t)(fb_get_gpi() << (20-GPI_AY_SHIFT)) >> (20+fb_scale);
+}
+
+#ifdef FB_HOST
+
+// Writes the displayed page to a binary PPM file, converting pixels to
+// 24 bit RGB and replicating them as the CRTC does. Returns 0 on success.
+int fb_snapshot(const char *filename)
+{
+	FILE *f;
+	uint8_t *p;
+	uint32_t c;
+	uint32_t h;
+	int16_t x, y;
+
+	if (!fb_host_mem || !(f = fopen(filename, "wb")))
+		return -1;
+	fprintf(f, "P6\n%d %d\n255\n", fb_width << fb_scale, fb_height << fb_scale);
+	p = fb_host_mem + ((fb_get_gpi() & GPI_PAGE) ? FB_PAGE_SIZE : 0);
+	for (y = 0; y < (fb_height << fb_scale); y++) {
+		for (x = 0; x < (fb_width << fb_scale); x++) {
+			switch(fb_fmt) {
+				case FB_FMT_16BPP:
+					h = ((uint16_t *)p)[x >> fb_scale];
+					c = ((h >> 8) & 0xF8) | (h >> 13)
+						| ((h << 5) & 0xFC00) | ((h >> 1) & 0x0300)
+						| ((h << 19) & 0xF80000) | ((h << 14) & 0x070000);
+					break;
+				case FB_FMT_8BPP:
+					c = ((uint32_t *)(fb_host_mem+(2*FB_PAGE_SIZE)))[p[x >> fb_scale]];
+					break;
+				default:
+					c = ((uint32_t *)p)[x >> fb_scale];
+			}
+			putc(c & 0xFF, f);
+			putc((c >> 8) & 0xFF, f);
+			putc((c >> 16) & 0xFF, f);
+		}
+		if (!((y+1) & ((1 << fb_scale)-1)))
+			p += fb_pitch << (2-fb_fmt);
+	}
+	return fclose(f) ? -1 : 0;
+}
+
+#endif
@@ -18,9 +18,40 @@
 #ifndef _FB_H_
 #define _FB_H_
 
-#include "xparameters.h"
+#include <stdint.h>
 
+#ifdef FB_HOST
+// host build: frame buffer memory is allocated on the heap by fb_init()
+extern uint8_t *fb_host_mem;
+#define FB_BASE ((uintptr_t)fb_host_mem)
+#else
+#include "xparameters.h"
+// DDR appears twice: at XPAR_AXI_BASEADDR through the CPU data cache, and
+// 512MBytes above that uncached
+#define FB_UNCACHED (XPAR_AXI_BASEADDR+0x20000000)
+#ifdef FB_CACHED
 #define FB_BASE XPAR_AXI_BASEADDR
+#else
+#define FB_BASE FB_UNCACHED
+#endif
+#endif
+
+// If FB_CACHED is defined, drawing goes through the data cache, and pixel
+// pointers are not volatile, so the compiler may combine and reorder stores.
+// fb_flush_range() or fb_flush_rect() must then be called to write drawing
+// back to DDR before it can be seen (fb_swap() flushes the whole cache).
+// Calls that draw a whole region or image flush what they draw:
+//   fb_fill, fb_clear, fb_swap, fb_set_pal, fb_tile_render, fb_copy_rect,
+//   fb_qoi_feed/fb_qoi_draw, and the fb_vdu.c console.
+// Primitive drawing calls, which are made many at a time, do not (one flush
+// per batch is cheaper); flush after a batch, or rely on fb_swap():
+//   the FB_PIXELxx pointers, fb_blit, fb_glyph_put(s), fb_span and the other
+//   fb_raster.c calls, and the hagl HAL (so all hagl drawing).
+#ifdef FB_CACHED
+#define FB_VOLATILE
+#else
+#define FB_VOLATILE volatile
+#endif
 
 #define FB_MODE_640x480p60		0
 #define FB_MODE_720x480p60  	1
@@ -38,10 +69,54 @@
 #define FB_MODE_720x576i50w 	13
 #define FB_MODE_1920x1080p50	14
 
-uint8_t fb_mode;
-int16_t fb_width;
-int16_t fb_height;
+// pixel formats (the value is also log2 of pixels per 32 bit word)
+#define FB_FMT_32BPP			0	// byte 0 = red, 1 = green, 2 = blue
+#define FB_FMT_16BPP			1	// RGB565 (red in bits 15:11)
+#define FB_FMT_8BPP				2	// palette index
+
+// replication: each pixel is displayed as a 1x1, 2x2 or 4x4 block, so
+// the frame buffer is the display size divided by 1, 2 or 4
+#define FB_SCALE_1X				0
+#define FB_SCALE_2X				1
+#define FB_SCALE_4X				2
+
+#define FB_PAGE_SIZE (1 << 23) // 8MBytes (see size_log2 generic of mig_bridge_crtc)
+#define FB_PAL_BASE (FB_BASE+(2*FB_PAGE_SIZE)) // palette (reloaded by CRTC every frame)
+#define FB_SPARE_BASE (FB_PAL_BASE+1024) // memory free for other uses (e.g. fb_vdu.c)
+#define FB_SPARE_SIZE (1 << 20) // 1MByte (more on hardware, but this is all the host build has)
+#define FB_MAX_HEIGHT 1080
+
+// pointers to pixel (x,y) of page being drawn, for each pixel format
+#define FB_PIXEL32(x,y) ((FB_VOLATILE uint32_t *)fb_row[y]+(x))
+#define FB_PIXEL16(x,y) ((FB_VOLATILE uint16_t *)fb_row[y]+(x))
+#define FB_PIXEL8(x,y) ((FB_VOLATILE uint8_t *)fb_row[y]+(x))
+
+extern uint8_t fb_mode;
+extern uint8_t fb_fmt;
+extern uint8_t fb_scale;
+extern int16_t fb_width;
+extern int16_t fb_height;
+extern int16_t fb_pitch; // pixels from one row to the next (multiple of 64)
+extern uint8_t fb_page; // page being drawn (0 or 1)
+extern uintptr_t fb_base; // base address of page being drawn
+extern uintptr_t fb_row[FB_MAX_HEIGHT]; // addresses of rows of page being drawn
 
 void fb_init(uint8_t mode);
+void fb_init_fmt(uint8_t mode, uint8_t fmt);
+void fb_init_scale(uint8_t mode, uint8_t fmt, uint8_t scale);
+void fb_set_pal(uint8_t i, uint32_t c);
+uint32_t fb_rgb(uint32_t c);
+void fb_swap();
+void fb_fill(uint32_t c);
+void fb_clear();
+void fb_flush_range(uintptr_t a, uint32_t n);
+void fb_flush_rect(int16_t x, int16_t y, int16_t w, int16_t h);
+void fb_flush();
+void fb_wait_vblank();
+uint8_t fb_in_vblank();
+int16_t fb_get_scanline();
+#ifdef FB_HOST
+int fb_snapshot(const char *filename);
+#endif
 
 #endif
@@ -0,0 +1,103 @@
+/*******************************************************************************
+** fb_blit.c                                                                  **
+** Sprite blitter for frame buffer (32 bpp).                                  **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#include <stdint.h>
+
+#include "fb.h"
+#include "fb_blit.h"
+
+// clip window (inclusive), intersected with the screen at each blit
+static int16_t clip_x0 = 0;
+static int16_t clip_y0 = 0;
+static int16_t clip_x1 = 0x7FFF;
+static int16_t clip_y1 = 0x7FFF;
+
+void fb_blit_clip(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+	clip_x0 = x0;
+	clip_y0 = y0;
+	clip_x1 = x1;
+	clip_y1 = y1;
+}
+
+// Blends s over d with alpha a (0..256). Red and blue are processed
+// together: with 8 bits of space above each, neither product can carry
+// into the next channel.
+uint32_t fb_blend(uint32_t d, uint32_t s, uint16_t a)
+{
+	uint32_t rb, g;
+
+	rb = (((s & 0x00FF00FF) * a) + ((d & 0x00FF00FF) * (256-a))) >> 8;
+	g = (((s & 0x0000FF00) * a) + ((d & 0x0000FF00) * (256-a))) >> 8;
+	return (rb & 0x00FF00FF) | (g & 0x0000FF00);
+}
+
+void fb_blit(int16_t x, int16_t y, const fb_sprite_t *s, uint8_t mode, uint32_t key)
+{
+	int16_t x0, y0, x1, y1;
+	uint16_t w, h, i;
+	uint32_t c, a;
+	const uint32_t *src;
+	FB_VOLATILE uint32_t *dst;
+
+	if (fb_fmt != FB_FMT_32BPP) // sprites are 32 bpp, and are not converted
+		return;
+
+	// clip
+	x0 = clip_x0 > 0 ? clip_x0 : 0;
+	y0 = clip_y0 > 0 ? clip_y0 : 0;
+	x1 = clip_x1 < fb_width-1 ? clip_x1 : fb_width-1;
+	y1 = clip_y1 < fb_height-1 ? clip_y1 : fb_height-1;
+	if (x > x0) x0 = x;
+	if (y > y0) y0 = y;
+	if (x+s->width-1 < x1) x1 = x+s->width-1;
+	if (y+s->height-1 < y1) y1 = y+s->height-1;
+	if (x0 > x1 || y0 > y1)
+		return;
+	w = x1+1-x0;
+	src = s->buf + ((y0-y) * s->pitch) + (x0-x);
+
+	for (h = y1+1-y0; h; h--, y0++, src += s->pitch) {
+		dst = FB_PIXEL32(x0, y0);
+		switch(mode) {
+			case FB_BLIT_KEY:
+				for (i = 0; i < w; i++)
+					if ((c = src[i]) != key)
+						dst[i] = c;
+				break;
+			case FB_BLIT_ALPHA:
+				for (i = 0; i < w; i++) {
+					c = src[i];
+					a = c >> 24;
+					if (a == 255)
+						dst[i] = c;
+					else if (a)
+						dst[i] = fb_blend(dst[i], c, a + (a >> 7));
+				}
+				break;
+			default:
+				for (i = 0; i+4 <= w; i += 4) {
+					dst[i] = src[i];
+					dst[i+1] = src[i+1];
+					dst[i+2] = src[i+2];
+					dst[i+3] = src[i+3];
+				}
+				for (; i < w; i++)
+					dst[i] = src[i];
+		}
+	}
+}
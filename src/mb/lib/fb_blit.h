@@ -0,0 +1,40 @@
+/*******************************************************************************
+** fb_blit.h                                                                  **
+** Sprite blitter for frame buffer (32 bpp).                                  **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#ifndef _FB_BLIT_H_
+#define _FB_BLIT_H_
+
+#include <stdint.h>
+
+#define FB_BLIT_OPAQUE	0	// copy all pixels
+#define FB_BLIT_KEY		1	// skip pixels equal to key colour
+#define FB_BLIT_ALPHA	2	// blend using alpha in byte 3 of each pixel
+
+typedef struct {
+	uint16_t width;
+	uint16_t height;
+	uint16_t pitch;			// pixels from one row to the next
+	const uint32_t *buf;
+} fb_sprite_t;
+
+void fb_blit_clip(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+
+// fb_blit draws nothing unless the frame buffer is in 32 bpp format
+void fb_blit(int16_t x, int16_t y, const fb_sprite_t *s, uint8_t mode, uint32_t key);
+uint32_t fb_blend(uint32_t d, uint32_t s, uint16_t a);
+
+#endif
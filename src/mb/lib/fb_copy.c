@@ -0,0 +1,168 @@
+/*******************************************************************************
+** fb_copy.c                                                                  **
+** Rectangle copy within the frame buffer (e.g. for scrolling).               **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#include <stdint.h>
+
+#include "fb.h"
+#include "fb_copy.h"
+
+// Rows are moved a 32 bit word at a time. Where the source and destination
+// are not equally aligned (e.g. moving by an odd number of pixels at 8 bpp),
+// aligned source words are read and shifted together, so that every access
+// is still a whole word apart from up to 3 bytes at each end of a row.
+
+// moves n bytes from s to d in ascending order (safe if d <= s)
+static void fb_move_up(uintptr_t d, uintptr_t s, uint32_t n)
+{
+	FB_VOLATILE uint32_t *dw;
+	FB_VOLATILE uint32_t *sw;
+	uint32_t w0, w1, m;
+	uint8_t sh;
+
+	for (; n && (d & 3); n--)
+		*(FB_VOLATILE uint8_t *)d++ = *(FB_VOLATILE uint8_t *)s++;
+	dw = (FB_VOLATILE uint32_t *)d;
+	m = n >> 2;
+	sh = (s & 3) << 3;
+	if (!sh) {
+		sw = (FB_VOLATILE uint32_t *)s;
+		for (; m >= 4; m -= 4) {
+			dw[0] = sw[0];
+			dw[1] = sw[1];
+			dw[2] = sw[2];
+			dw[3] = sw[3];
+			dw += 4;
+			sw += 4;
+		}
+		while (m--)
+			*dw++ = *sw++;
+	}
+	else if (m) {
+		sw = (FB_VOLATILE uint32_t *)(s & ~3);
+		w0 = *sw++;
+		while (m--) {
+			w1 = *sw++;
+			*dw++ = (w0 >> sh) | (w1 << (32-sh));
+			w0 = w1;
+		}
+	}
+	d += n & ~3;
+	s += n & ~3;
+	for (n &= 3; n; n--)
+		*(FB_VOLATILE uint8_t *)d++ = *(FB_VOLATILE uint8_t *)s++;
+}
+
+// moves n bytes from s to d in descending order (safe if d >= s)
+static void fb_move_down(uintptr_t d, uintptr_t s, uint32_t n)
+{
+	FB_VOLATILE uint32_t *dw;
+	FB_VOLATILE uint32_t *sw;
+	uint32_t w0, w1, m;
+	uint8_t sh;
+
+	d += n;
+	s += n;
+	for (; n && (d & 3); n--)
+		*(FB_VOLATILE uint8_t *)--d = *(FB_VOLATILE uint8_t *)--s;
+	dw = (FB_VOLATILE uint32_t *)d;
+	m = n >> 2;
+	sh = (s & 3) << 3;
+	if (!sh) {
+		sw = (FB_VOLATILE uint32_t *)s;
+		for (; m >= 4; m -= 4) {
+			dw -= 4;
+			sw -= 4;
+			dw[3] = sw[3];
+			dw[2] = sw[2];
+			dw[1] = sw[1];
+			dw[0] = sw[0];
+		}
+		while (m--)
+			*--dw = *--sw;
+	}
+	else if (m) {
+		sw = (FB_VOLATILE uint32_t *)(s & ~3);
+		w1 = *sw;
+		while (m--) {
+			w0 = *--sw;
+			*--dw = (w0 >> sh) | (w1 << (32-sh));
+			w1 = w0;
+		}
+	}
+	d -= n & ~3;
+	s -= n & ~3;
+	for (n &= 3; n; n--)
+		*(FB_VOLATILE uint8_t *)--d = *(FB_VOLATILE uint8_t *)--s;
+}
+
+// Copies the w x h rectangle at (sx,sy) to (dx,dy) on the page being
+// drawn. The areas may overlap: rows are copied bottom up when moving
+// down, and right to left when moving right, as memmove() does. Both
+// areas are clipped to the screen.
+void fb_copy_rect(int16_t sx, int16_t sy, int16_t w, int16_t h, int16_t dx, int16_t dy)
+{
+	uintptr_t soff, doff;
+	uint32_t n;
+	int16_t y;
+
+	if (sx < 0) {
+		w += sx;
+		dx -= sx;
+		sx = 0;
+	}
+	if (dx < 0) {
+		w += dx;
+		sx -= dx;
+		dx = 0;
+	}
+	if (sy < 0) {
+		h += sy;
+		dy -= sy;
+		sy = 0;
+	}
+	if (dy < 0) {
+		h += dy;
+		sy -= dy;
+		dy = 0;
+	}
+	if (sx+w > fb_width)
+		w = fb_width-sx;
+	if (dx+w > fb_width)
+		w = fb_width-dx;
+	if (sy+h > fb_height)
+		h = fb_height-sy;
+	if (dy+h > fb_height)
+		h = fb_height-dy;
+	if (w <= 0 || h <= 0)
+		return;
+	soff = (sx << 2) >> fb_fmt;
+	doff = (dx << 2) >> fb_fmt;
+	n = (w << 2) >> fb_fmt;
+	if (dy > sy)
+		for (y = h-1; y >= 0; y--)
+			fb_move_up(fb_row[dy+y]+doff, fb_row[sy+y]+soff, n);
+	else if (dy < sy)
+		for (y = 0; y < h; y++)
+			fb_move_up(fb_row[dy+y]+doff, fb_row[sy+y]+soff, n);
+	else if (dx > sx)
+		for (y = 0; y < h; y++)
+			fb_move_down(fb_row[dy+y]+doff, fb_row[sy+y]+soff, n);
+	else if (dx < sx)
+		for (y = 0; y < h; y++)
+			fb_move_up(fb_row[dy+y]+doff, fb_row[sy+y]+soff, n);
+	fb_flush_rect(dx, dy, w, h);
+}
@@ -0,0 +1,25 @@
+/*******************************************************************************
+** fb_copy.h                                                                  **
+** Rectangle copy within the frame buffer (e.g. for scrolling).               **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#ifndef _FB_COPY_H_
+#define _FB_COPY_H_
+
+#include <stdint.h>
+
+void fb_copy_rect(int16_t sx, int16_t sy, int16_t w, int16_t h, int16_t dx, int16_t dy);
+
+#endif
@@ -0,0 +1,158 @@
+/*******************************************************************************
+** fb_glyph.c                                                                 **
+** Glyph cache for fast text rendering on the frame buffer.                   **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#include <stdint.h>
+
+#include "fb.h"
+#include "fb_glyph.h"
+
+// Each cache slot holds one character expanded to pixels in the current
+// format and colours, with each row padded to a whole number of words.
+// Slots are direct mapped by character code.
+
+static uint32_t cache[FB_GLYPH_CACHE_WORDS];
+static uint16_t tag[FB_GLYPH_SLOTS_MAX];	// code held by slot, or 0xFFFF if empty
+static const fb_font_t *glyph_font;
+static uint32_t glyph_fg, glyph_bg;
+static uint8_t glyph_fmt;
+static uint8_t row_words;					// words per cached row
+static uint8_t row_whole;					// rows are a whole number of words
+static uint16_t slot_words;					// words per slot
+static uint8_t slot_mask;
+
+static void fb_glyph_flush()
+{
+	uint16_t i;
+
+	for (i = 0; i < FB_GLYPH_SLOTS_MAX; i++)
+		tag[i] = 0xFFFF;
+}
+
+// font width must be 1..8, and font height such that at least one slot fits
+void fb_glyph_init(const fb_font_t *font, uint32_t fg, uint32_t bg)
+{
+	uint16_t n;
+
+	glyph_font = font;
+	glyph_fmt = fb_fmt;
+	row_words = (((font->width << 2) >> glyph_fmt) + 3) >> 2;
+	row_whole = !(((font->width << 2) >> glyph_fmt) & 3);
+	slot_words = row_words * font->height;
+	for (n = 1; n < FB_GLYPH_SLOTS_MAX && (n << 1) * slot_words <= FB_GLYPH_CACHE_WORDS; n <<= 1)
+		;
+	slot_mask = n-1;
+	fb_glyph_colour(fg, bg);
+}
+
+// colours are pixel values in the current format
+void fb_glyph_colour(uint32_t fg, uint32_t bg)
+{
+	glyph_fg = fg;
+	glyph_bg = bg;
+	fb_glyph_flush();
+}
+
+// returns cached pixels for character c, expanding it on a miss
+static uint32_t *fb_glyph_get(uint8_t c)
+{
+	uint8_t s, r, i, b;
+	uint32_t *p, *q;
+	const uint8_t *bits;
+
+	s = c & slot_mask;
+	p = cache + (s * slot_words);
+	if (tag[s] == c)
+		return p;
+	tag[s] = c;
+	bits = glyph_font->bits + (c * glyph_font->height);
+	for (r = 0, q = p; r < glyph_font->height; r++, q += row_words) {
+		b = bits[r];
+		for (i = 0; i < glyph_font->width; i++, b <<= 1) {
+			switch(glyph_fmt) {
+				case FB_FMT_8BPP:
+					((uint8_t *)q)[i] = b & 0x80 ? glyph_fg : glyph_bg;
+					break;
+				case FB_FMT_16BPP:
+					((uint16_t *)q)[i] = b & 0x80 ? glyph_fg : glyph_bg;
+					break;
+				default:
+					q[i] = b & 0x80 ? glyph_fg : glyph_bg;
+			}
+		}
+	}
+	return p;
+}
+
+void fb_glyph_put(int16_t x, int16_t y, uint8_t c)
+{
+	uint8_t w, h, r, i, i0, i1;
+	uint32_t *p;
+	FB_VOLATILE uint32_t *d;
+
+	w = glyph_font->width;
+	h = glyph_font->height;
+	if (x >= fb_width || y >= fb_height || x+w <= 0 || y+h <= 0)
+		return;
+	p = fb_glyph_get(c);
+	r = 0;
+	if (y < 0) {
+		r = -y;
+		p += r * row_words;
+	}
+	if (y+h > fb_height)
+		h = fb_height-y;
+	if (row_whole && x >= 0 && x+w <= fb_width && !(((x << 2) >> glyph_fmt) & 3)) {
+		// whole glyph row is word aligned in frame buffer: copy words
+		for (; r < h; r++, p += row_words) {
+			d = (FB_VOLATILE uint32_t *)(fb_row[y+r] + ((x << 2) >> glyph_fmt));
+			for (i = 0; i+2 <= row_words; i += 2) {
+				d[i] = p[i];
+				d[i+1] = p[i+1];
+			}
+			if (i < row_words)
+				d[i] = p[i];
+		}
+		return;
+	}
+	// partly off screen, or not word aligned: copy pixels
+	i0 = x < 0 ? -x : 0;
+	i1 = x+w > fb_width ? fb_width-x : w;
+	for (; r < h; r++, p += row_words) {
+		for (i = i0; i < i1; i++) {
+			switch(glyph_fmt) {
+				case FB_FMT_8BPP:
+					*FB_PIXEL8(x+i, y+r) = ((uint8_t *)p)[i];
+					break;
+				case FB_FMT_16BPP:
+					*FB_PIXEL16(x+i, y+r) = ((uint16_t *)p)[i];
+					break;
+				default:
+					*FB_PIXEL32(x+i, y+r) = p[i];
+			}
+		}
+	}
+}
+
+// returns x position following string
+int16_t fb_glyph_puts(int16_t x, int16_t y, const char *s)
+{
+	while (*s) {
+		fb_glyph_put(x, y, *s++);
+		x += glyph_font->width;
+	}
+	return x;
+}
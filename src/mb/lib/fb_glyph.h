@@ -0,0 +1,40 @@
+/*******************************************************************************
+** fb_glyph.h                                                                 **
+** Glyph cache for fast text rendering on the frame buffer.                   **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#ifndef _FB_GLYPH_H_
+#define _FB_GLYPH_H_
+
+#include <stdint.h>
+
+// cache size (32 bit words); slots are allocated in powers of 2
+#ifndef FB_GLYPH_CACHE_WORDS
+#define FB_GLYPH_CACHE_WORDS 2048
+#endif
+#define FB_GLYPH_SLOTS_MAX 128
+
+typedef struct {
+	uint8_t width;			// pixels (1..8)
+	uint8_t height;			// rows (1..32)
+	const uint8_t *bits;	// height bytes per character from code 0, bit 7 = leftmost
+} fb_font_t;
+
+void fb_glyph_init(const fb_font_t *font, uint32_t fg, uint32_t bg);
+void fb_glyph_colour(uint32_t fg, uint32_t bg);
+void fb_glyph_put(int16_t x, int16_t y, uint8_t c);
+int16_t fb_glyph_puts(int16_t x, int16_t y, const char *s);
+
+#endif
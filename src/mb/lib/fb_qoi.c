@@ -0,0 +1,222 @@
+/*******************************************************************************
+** fb_qoi.c                                                                   **
+** Streaming QOI image decoder, drawing straight to the frame buffer.         **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#include <stdint.h>
+
+#include "fb.h"
+#include "fb_raster.h"
+#include "fb_qoi.h"
+
+// Decodes the QOI format (https://qoiformat.org/) a byte at a time, so
+// that the input may arrive in chunks of any size, e.g. from BRAM or as
+// it is read from flash. There is no image buffer: decoded pixels are
+// gathered into spans of one colour, which are drawn as each one ends.
+// Pixels are converted to the current format (at 8 bpp, to the RGB332
+// palette set up by fb_init_fmt()). Pixels with zero alpha are not drawn;
+// otherwise alpha is ignored. Images are clipped to the fb_raster_clip()
+// window, and decoding stops after the last visible row.
+
+#define QOI_OP_INDEX	0x00
+#define QOI_OP_DIFF		0x40
+#define QOI_OP_LUMA		0x80
+#define QOI_OP_RUN		0xC0
+#define QOI_OP_RGB		0xFE
+#define QOI_OP_RGBA		0xFF
+#define QOI_MASK		0xC0
+
+#define QOI_HEADER_SIZE 14
+#define QOI_TRANSPARENT 0xFFFFFFFF // not a valid pixel value in any format
+
+static uint32_t qoi_be32(const uint8_t *b)
+{
+	return ((uint32_t)b[0] << 24) | ((uint32_t)b[1] << 16) | ((uint32_t)b[2] << 8) | b[3];
+}
+
+// converts pixel px to the current format
+static uint32_t qoi_pixel(uint32_t px)
+{
+	return (px >> 24) ? fb_rgb(px) : QOI_TRANSPARENT;
+}
+
+// draws the pending span
+static void qoi_span(fb_qoi_t *d)
+{
+	int16_t x = d->x + d->span_x;
+	int16_t y = d->y + d->row;
+
+	if (d->span_n && d->span_c != QOI_TRANSPARENT && y >= d->cy0) {
+		if (d->span_n > 1)
+			fb_span(x, x+d->span_n-1, y, d->span_c);
+		else if (x >= d->cx0 && x <= d->cx1) {
+			switch(fb_fmt) {
+				case FB_FMT_16BPP:
+					*FB_PIXEL16(x, y) = d->span_c;
+					break;
+				case FB_FMT_8BPP:
+					*FB_PIXEL8(x, y) = d->span_c;
+					break;
+				default:
+					*FB_PIXEL32(x, y) = d->span_c;
+			}
+		}
+	}
+	d->span_n = 0;
+}
+
+// emits n pixels of the current colour
+static void qoi_put(fb_qoi_t *d, uint8_t n)
+{
+	uint16_t m;
+
+	while (n) {
+		if (d->span_n && d->c != d->span_c)
+			qoi_span(d);
+		if (!d->span_n) {
+			d->span_c = d->c;
+			d->span_x = d->col;
+		}
+		m = d->w - d->col;
+		if (m > n)
+			m = n;
+		d->span_n += m;
+		d->col += m;
+		n -= m;
+		if (d->col == d->w) {
+			qoi_span(d);
+			d->col = 0;
+			if (++d->row == d->h || d->y + d->row > d->cy1) {
+				fb_flush_rect(d->x, d->y, d->w, d->row);
+				d->status = FB_QOI_DONE;
+				return;
+			}
+		}
+	}
+}
+
+static void qoi_header(fb_qoi_t *d)
+{
+	const uint8_t *b = d->buf;
+	uint32_t w = qoi_be32(b+4);
+	uint32_t h = qoi_be32(b+8);
+
+	if (b[0] != 'q' || b[1] != 'o' || b[2] != 'i' || b[3] != 'f'
+		|| !w || !h || w > 0x7FFF || h > 0x7FFF) {
+		d->status = FB_QOI_ERROR;
+		return;
+	}
+	d->w = w;
+	d->h = h;
+	if (d->y + d->h <= d->cy0 || d->y > d->cy1) // nothing to draw
+		d->status = FB_QOI_DONE;
+}
+
+static void qoi_op(fb_qoi_t *d)
+{
+	const uint8_t *b = d->buf;
+	uint8_t r = d->px, g = d->px >> 8, bl = d->px >> 16, a = d->px >> 24;
+	int8_t dg;
+
+	if (b[0] == QOI_OP_RGB) {
+		r = b[1];
+		g = b[2];
+		bl = b[3];
+	}
+	else if (b[0] == QOI_OP_RGBA) {
+		r = b[1];
+		g = b[2];
+		bl = b[3];
+		a = b[4];
+	}
+	else switch(b[0] & QOI_MASK) {
+		case QOI_OP_INDEX:
+			d->px = d->index[b[0]];
+			d->c = qoi_pixel(d->px);
+			qoi_put(d, 1);
+			return;
+		case QOI_OP_DIFF:
+			r += ((b[0] >> 4) & 3) - 2;
+			g += ((b[0] >> 2) & 3) - 2;
+			bl += (b[0] & 3) - 2;
+			break;
+		case QOI_OP_LUMA:
+			dg = (b[0] & 0x3F) - 32;
+			r += dg - 8 + (b[1] >> 4);
+			g += dg;
+			bl += dg - 8 + (b[1] & 0x0F);
+			break;
+		default: // QOI_OP_RUN
+			d->index[(r*3 + g*5 + bl*7 + a*11) & 63] = d->px;
+			qoi_put(d, (b[0] & 0x3F) + 1);
+			return;
+	}
+	d->px = r | (g << 8) | ((uint32_t)bl << 16) | ((uint32_t)a << 24);
+	d->index[(r*3 + g*5 + bl*7 + a*11) & 63] = d->px;
+	d->c = qoi_pixel(d->px);
+	qoi_put(d, 1);
+}
+
+// starts decoding an image to be drawn with its top left at (x,y)
+void fb_qoi_begin(fb_qoi_t *d, int16_t x, int16_t y)
+{
+	uint8_t i;
+
+	d->x = x;
+	d->y = y;
+	d->w = 0;
+	d->h = 0;
+	d->col = 0;
+	d->row = 0;
+	fb_raster_get_clip(&d->cx0, &d->cy0, &d->cx1, &d->cy1);
+	d->px = 0xFF000000;
+	d->c = qoi_pixel(d->px);
+	d->span_n = 0;
+	d->len = 0;
+	d->need = QOI_HEADER_SIZE;
+	d->status = FB_QOI_MORE;
+	for (i = 0; i < 64; i++)
+		d->index[i] = 0;
+}
+
+// decodes the next n bytes of the image, returning the status; data
+// after the last pixel (e.g. the end marker) is ignored
+int8_t fb_qoi_feed(fb_qoi_t *d, const uint8_t *s, uint32_t n)
+{
+	uint8_t *b = d->buf;
+
+	for (; n && d->status == FB_QOI_MORE; n--) {
+		b[d->len++] = *s++;
+		if (d->len == 1 && d->w) // first byte of an op
+			d->need = b[0] == QOI_OP_RGB ? 4 : b[0] == QOI_OP_RGBA ? 5 : (b[0] & QOI_MASK) == QOI_OP_LUMA ? 2 : 1;
+		if (d->len < d->need)
+			continue;
+		d->len = 0;
+		if (d->w)
+			qoi_op(d);
+		else
+			qoi_header(d);
+	}
+	return d->status;
+}
+
+// draws a whole image held in memory (n bytes at qoi)
+int8_t fb_qoi_draw(int16_t x, int16_t y, const uint8_t *qoi, uint32_t n)
+{
+	static fb_qoi_t d;
+
+	fb_qoi_begin(&d, x, y);
+	return fb_qoi_feed(&d, qoi, n);
+}
@@ -0,0 +1,49 @@
+/*******************************************************************************
+** fb_qoi.h                                                                   **
+** Streaming QOI image decoder, drawing straight to the frame buffer.         **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#ifndef _FB_QOI_H_
+#define _FB_QOI_H_
+
+#include <stdint.h>
+
+// decoder status
+#define FB_QOI_MORE		0	// more data needed
+#define FB_QOI_DONE		1	// image drawn
+#define FB_QOI_ERROR	-1	// bad header
+
+typedef struct {
+	int16_t x, y;			// screen position of top left of image
+	uint16_t w, h;			// image size (0 until header decoded)
+	uint16_t col, row;		// position of next pixel in image
+	int16_t cx0, cy0;		// clip window (inclusive)
+	int16_t cx1, cy1;
+	uint32_t px;			// current pixel: byte 0 = red, 1 = green, 2 = blue, 3 = alpha
+	uint32_t c;				// current pixel in frame buffer format
+	uint32_t span_c;		// pending span: colour
+	uint16_t span_x;		// start column
+	uint16_t span_n;		// length
+	uint8_t buf[14];		// header or op being received
+	uint8_t len, need;
+	int8_t status;
+	uint32_t index[64];		// previously seen pixels
+} fb_qoi_t;
+
+void fb_qoi_begin(fb_qoi_t *d, int16_t x, int16_t y);
+int8_t fb_qoi_feed(fb_qoi_t *d, const uint8_t *s, uint32_t n);
+int8_t fb_qoi_draw(int16_t x, int16_t y, const uint8_t *qoi, uint32_t n);
+
+#endif
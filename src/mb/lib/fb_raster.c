@@ -0,0 +1,266 @@
+/*******************************************************************************
+** fb_raster.c                                                                **
+** Scanline rasteriser for filled shapes on the frame buffer.                 **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#include <stdint.h>
+
+#include "fb.h"
+#include "fb_raster.h"
+
+// Shapes are broken into horizontal spans, with edges stepped from one
+// scanline to the next in 16.16 fixed point. Spans are inclusive of
+// both ends, and shapes include their vertices/boundaries.
+
+// clip window (inclusive), intersected with the screen at each span
+static int16_t clip_x0 = 0;
+static int16_t clip_y0 = 0;
+static int16_t clip_x1 = 0x7FFF;
+static int16_t clip_y1 = 0x7FFF;
+
+void fb_raster_clip(int16_t x0, int16_t y0, int16_t x1, int16_t y1)
+{
+	clip_x0 = x0;
+	clip_y0 = y0;
+	clip_x1 = x1;
+	clip_y1 = y1;
+}
+
+// returns the clip window intersected with the screen
+void fb_raster_get_clip(int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1)
+{
+	*x0 = clip_x0 > 0 ? clip_x0 : 0;
+	*y0 = clip_y0 > 0 ? clip_y0 : 0;
+	*x1 = clip_x1 < fb_width-1 ? clip_x1 : fb_width-1;
+	*y1 = clip_y1 < fb_height-1 ? clip_y1 : fb_height-1;
+}
+
+// fills pixels x0..x1 of row y, storing whole words where possible
+void fb_span(int16_t x0, int16_t x1, int16_t y, uint32_t c)
+{
+	FB_VOLATILE uint32_t *p;
+	FB_VOLATILE uint16_t *p16;
+	FB_VOLATILE uint8_t *p8;
+	int16_t n;
+
+	if (y < clip_y0 || y > clip_y1 || y < 0 || y >= fb_height)
+		return;
+	if (x0 < clip_x0) x0 = clip_x0;
+	if (x0 < 0) x0 = 0;
+	if (x1 > clip_x1) x1 = clip_x1;
+	if (x1 >= fb_width) x1 = fb_width-1;
+	n = x1+1-x0;
+	if (n <= 0)
+		return;
+	switch(fb_fmt) {
+		case FB_FMT_8BPP:
+			p8 = FB_PIXEL8(x0, y);
+			for (; n && ((uintptr_t)p8 & 3); n--)
+				*p8++ = c;
+			c = (c & 0xFF) * 0x01010101;
+			for (p = (FB_VOLATILE uint32_t *)p8; n >= 4; n -= 4)
+				*p++ = c;
+			for (p8 = (FB_VOLATILE uint8_t *)p; n; n--)
+				*p8++ = c;
+			return;
+		case FB_FMT_16BPP:
+			p16 = FB_PIXEL16(x0, y);
+			if (n && ((uintptr_t)p16 & 2)) {
+				*p16++ = c;
+				n--;
+			}
+			c = (c & 0xFFFF) * 0x00010001;
+			for (p = (FB_VOLATILE uint32_t *)p16; n >= 2; n -= 2)
+				*p++ = c;
+			if (n)
+				*(FB_VOLATILE uint16_t *)p = c;
+			return;
+		default:
+			p = FB_PIXEL32(x0, y);
+			for (; n >= 4; n -= 4) {
+				p[0] = c;
+				p[1] = c;
+				p[2] = c;
+				p[3] = c;
+				p += 4;
+			}
+			while (n--)
+				*p++ = c;
+	}
+}
+
+#define SWAP(a,b) { int16_t t = a; a = b; b = t; }
+
+// 16.16 slope of edge from (xa,ya) to (xb,yb), where yb > ya
+static int32_t fb_slope(int16_t xa, int16_t ya, int16_t xb, int16_t yb)
+{
+	return ((int32_t)(xb-xa) * 65536) / (yb-ya);
+}
+
+void fb_fill_triangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint32_t c)
+{
+	int32_t xl, xs, dl, ds;
+	int16_t y, ye, a, b;
+
+	// sort vertices by y
+	if (y1 < y0) { SWAP(x0, x1); SWAP(y0, y1); }
+	if (y2 < y1) { SWAP(x1, x2); SWAP(y1, y2); }
+	if (y1 < y0) { SWAP(x0, x1); SWAP(y0, y1); }
+	if (y0 == y2) { // flat
+		a = x0 < x1 ? x0 : x1;
+		a = a < x2 ? a : x2;
+		b = x0 > x1 ? x0 : x1;
+		b = b > x2 ? b : x2;
+		fb_span(a, b, y0, c);
+		return;
+	}
+
+	// long edge 0 to 2, short edges 0 to 1 then 1 to 2
+	y = y0 > clip_y0 ? y0 : clip_y0;
+	if (y < 0)
+		y = 0;
+	ye = y2 < clip_y1 ? y2 : clip_y1;
+	if (ye >= fb_height)
+		ye = fb_height-1;
+	if (y > ye)
+		return;
+	dl = fb_slope(x0, y0, x2, y2);
+	xl = ((int32_t)x0 * 65536) + 0x8000 + (dl * (y-y0));
+	if (y < y1) {
+		ds = fb_slope(x0, y0, x1, y1);
+		xs = ((int32_t)x0 * 65536) + 0x8000 + (ds * (y-y0));
+		for (; y < y1 && y <= ye; y++, xl += dl, xs += ds) {
+			a = xl >> 16;
+			b = xs >> 16;
+			if (a < b)
+				fb_span(a, b, y, c);
+			else
+				fb_span(b, a, y, c);
+		}
+	}
+	ds = y2 > y1 ? fb_slope(x1, y1, x2, y2) : 0;
+	xs = ((int32_t)x1 * 65536) + 0x8000 + (ds * (y-y1));
+	for (; y <= ye; y++, xl += dl, xs += ds) {
+		a = xl >> 16;
+		b = xs >> 16;
+		if (a < b)
+			fb_span(a, b, y, c);
+		else
+			fb_span(b, a, y, c);
+	}
+}
+
+// Fills a polygon of n vertices (xy holds x0,y0,x1,y1...), which may be
+// concave or self intersecting (even-odd rule).
+void fb_fill_polygon(uint8_t n, const int16_t *xy, uint32_t c)
+{
+	int32_t ex[FB_POLY_MAX], dx[FB_POLY_MAX];
+	int16_t ey0[FB_POLY_MAX], ey1[FB_POLY_MAX], xs[FB_POLY_MAX];
+	int16_t y, ymin, ymax, ye, xa, ya, xb, yb, t;
+	uint8_t i, j, k, ne;
+
+	if (n < 3 || n > FB_POLY_MAX)
+		return;
+	// build edge list (horizontal edges are dropped)
+	ymin = ymax = xy[1];
+	for (i = 0, ne = 0; i < n; i++) {
+		xa = xy[i << 1];
+		ya = xy[(i << 1) + 1];
+		j = i+1 < n ? i+1 : 0;
+		xb = xy[j << 1];
+		yb = xy[(j << 1) + 1];
+		if (ya < ymin) ymin = ya;
+		if (ya > ymax) ymax = ya;
+		if (ya == yb)
+			continue;
+		if (yb < ya) {
+			SWAP(xa, xb);
+			SWAP(ya, yb);
+		}
+		ey0[ne] = ya;
+		ey1[ne] = yb;
+		dx[ne] = fb_slope(xa, ya, xb, yb);
+		ex[ne] = ((int32_t)xa * 65536) + 0x8000;
+		ne++;
+	}
+	if (!ne) { // flat
+		for (i = 1, xa = xb = xy[0]; i < n; i++) {
+			t = xy[i << 1];
+			if (t < xa) xa = t;
+			if (t > xb) xb = t;
+		}
+		fb_span(xa, xb, ymin, c);
+		return;
+	}
+	y = ymin > clip_y0 ? ymin : clip_y0;
+	if (y < 0)
+		y = 0;
+	ye = ymax < clip_y1 ? ymax : clip_y1;
+	if (ye >= fb_height)
+		ye = fb_height-1;
+	for (i = 0; i < ne; i++) // advance edges to first row
+		if (y > ey0[i] && y <= ey1[i])
+			ex[i] += dx[i] * (y-ey0[i]);
+
+	// edges span ey0 <= y < ey1, except on the last row (ey0 < y <= ey1)
+	for (; y <= ye; y++) {
+		for (i = 0, k = 0; i < ne; i++) {
+			if (y < ey1[i] ? y >= ey0[i] : (y == ymax && y == ey1[i])) {
+				t = ex[i] >> 16;
+				for (j = k++; j && xs[j-1] > t; j--) // insertion sort
+					xs[j] = xs[j-1];
+				xs[j] = t;
+			}
+			if (y >= ey0[i] && y < ey1[i])
+				ex[i] += dx[i];
+		}
+		for (i = 0; i+1 < k; i += 2)
+			fb_span(xs[i], xs[i+1], y, c);
+	}
+}
+
+// Fills an ellipse with semi-axes a and b. The half width of each row is
+// found incrementally from the error term x^2.b^2 + y^2.a^2 - a^2.b^2,
+// which is updated by addition only (no 64 bit multiplies).
+void fb_fill_ellipse(int16_t xc, int16_t yc, int16_t a, int16_t b, uint32_t c)
+{
+	int64_t e, ex, ey, a2, b2;
+	int16_t x, y;
+
+	if (a < 0 || b < 0)
+		return;
+	a2 = (int32_t)a * a;
+	b2 = (int32_t)b * b;
+	e = 0;							// error at x = a, y = 0
+	ex = ((int32_t)(2 * a) - 1) * b2;	// error decrease for x-1 (2x-1).b^2
+	ey = a2;						// error increase for y+1 (2y+1).a^2
+	for (x = a, y = 0; y <= b; y++) {
+		while (x > 0 && e > 0) {
+			e -= ex;
+			ex -= 2 * b2;
+			x--;
+		}
+		fb_span(xc-x, xc+x, yc-y, c);
+		if (y)
+			fb_span(xc-x, xc+x, yc+y, c);
+		e += ey;
+		ey += 2 * a2;
+	}
+}
+
+void fb_fill_circle(int16_t xc, int16_t yc, int16_t r, uint32_t c)
+{
+	fb_fill_ellipse(xc, yc, r, r, c);
+}
@@ -0,0 +1,35 @@
+/*******************************************************************************
+** fb_raster.h                                                                **
+** Scanline rasteriser for filled shapes on the frame buffer.                 **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#ifndef _FB_RASTER_H_
+#define _FB_RASTER_H_
+
+#include <stdint.h>
+
+#define FB_POLY_MAX 32 // maximum polygon vertices
+
+// colours are pixel values in the current format; coordinates should be
+// within -16384..16383
+void fb_raster_clip(int16_t x0, int16_t y0, int16_t x1, int16_t y1);
+void fb_raster_get_clip(int16_t *x0, int16_t *y0, int16_t *x1, int16_t *y1);
+void fb_span(int16_t x0, int16_t x1, int16_t y, uint32_t c);
+void fb_fill_triangle(int16_t x0, int16_t y0, int16_t x1, int16_t y1, int16_t x2, int16_t y2, uint32_t c);
+void fb_fill_polygon(uint8_t n, const int16_t *xy, uint32_t c);
+void fb_fill_ellipse(int16_t xc, int16_t yc, int16_t a, int16_t b, uint32_t c);
+void fb_fill_circle(int16_t xc, int16_t yc, int16_t r, uint32_t c);
+
+#endif
@@ -0,0 +1,158 @@
+/*******************************************************************************
+** fb_tile.c                                                                  **
+** Dirty tile tracking and tile based rendering for frame buffer.             **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#include <stdint.h>
+
+#include "fb.h"
+#include "fb_tile.h"
+
+// The screen is divided into tiles, each with a dirty bit per page.
+// fb_tile_render() renders each dirty tile of the page being drawn into
+// a tile buffer in local memory, using a caller supplied function, then
+// copies it to the frame buffer (writing it back from the data cache,
+// if FB_CACHED). Only tiles that have changed are written to DDR, so CPU
+// writes compete less with CRTC reads.
+// Marking a region dirty marks it in both pages, so that double
+// buffered applications bring each page up to date in turn.
+
+#define TILES_MAX (((1920+FB_TILE_SIZE-1)/FB_TILE_SIZE)*((1080+FB_TILE_SIZE-1)/FB_TILE_SIZE))
+
+static uint32_t fb_tile_dirty[2][(TILES_MAX+31)/32];
+static uint16_t fb_tiles_x, fb_tiles_y;
+static fb_tile_t fb_tile;
+
+// call after fb_init; marks all tiles dirty
+void fb_tile_init()
+{
+	fb_tiles_x = (fb_width+FB_TILE_SIZE-1) >> FB_TILE_SIZE_LOG2;
+	fb_tiles_y = (fb_height+FB_TILE_SIZE-1) >> FB_TILE_SIZE_LOG2;
+	fb_tile_mark_all();
+}
+
+void fb_tile_mark(int16_t x, int16_t y, uint16_t w, uint16_t h)
+{
+	int16_t x1, y1;
+	uint16_t tx, ty, i;
+
+	x1 = x+w-1;
+	y1 = y+h-1;
+	if (x < 0) x = 0;
+	if (y < 0) y = 0;
+	if (x1 >= fb_width) x1 = fb_width-1;
+	if (y1 >= fb_height) y1 = fb_height-1;
+	if (w == 0 || h == 0 || x > x1 || y > y1)
+		return;
+	for (ty = y >> FB_TILE_SIZE_LOG2; ty <= (y1 >> FB_TILE_SIZE_LOG2); ty++) {
+		i = (ty * fb_tiles_x) + (x >> FB_TILE_SIZE_LOG2);
+		for (tx = x >> FB_TILE_SIZE_LOG2; tx <= (x1 >> FB_TILE_SIZE_LOG2); tx++, i++) {
+			fb_tile_dirty[0][i >> 5] |= 1U << (i & 31);
+			fb_tile_dirty[1][i >> 5] |= 1U << (i & 31);
+		}
+	}
+}
+
+void fb_tile_mark_all()
+{
+	fb_tile_mark(0, 0, fb_width, fb_height);
+}
+
+// copies tile to frame buffer, converting from 32 bit words to the
+// current pixel format; at 16 and 8 bpp, 2 or 4 pixels are packed into
+// each 32 bit store (tile x is a multiple of FB_TILE_SIZE, so rows are
+// word aligned) to keep the number of DDR write transactions down, with
+// single pixel stores only for an odd width tail at the right edge
+static void fb_tile_flush(fb_tile_t *t)
+{
+	uint32_t *s = t->buf;
+	FB_VOLATILE uint32_t *p;
+	uint16_t x, y;
+
+	for (y = 0; y < t->h; y++) {
+		p = (FB_VOLATILE uint32_t *)(fb_row[t->y+y] + (t->x << (2-fb_fmt)));
+		switch(fb_fmt) {
+			case FB_FMT_16BPP:
+				for (x = 0; x+2 <= t->w; x += 2)
+					*p++ = (s[x] & 0xFFFF) | (s[x+1] << 16);
+				if (x < t->w)
+					*(FB_VOLATILE uint16_t *)p = s[x];
+				break;
+			case FB_FMT_8BPP:
+				for (x = 0; x+4 <= t->w; x += 4)
+					*p++ = (s[x] & 0xFF) | ((s[x+1] & 0xFF) << 8)
+						| ((s[x+2] & 0xFF) << 16) | (s[x+3] << 24);
+				for (; x < t->w; x++)
+					((FB_VOLATILE uint8_t *)p)[x & 3] = s[x];
+				break;
+			default:
+				for (x = 0; x < t->w; x++)
+					p[x] = s[x];
+		}
+		s += FB_TILE_SIZE;
+	}
+}
+
+// renders and writes out the dirty tiles of the page being drawn,
+// returning the number of tiles written
+uint16_t fb_tile_render(void (*render)(fb_tile_t *t))
+{
+	fb_tile_t *t = &fb_tile;
+	uint32_t *dirty = fb_tile_dirty[fb_page];
+	uint16_t i, n, tx, ty;
+
+	n = 0;
+	i = 0;
+	for (ty = 0; ty < fb_tiles_y; ty++) {
+		for (tx = 0; tx < fb_tiles_x; tx++, i++) {
+			if (!(dirty[i >> 5] & (1U << (i & 31))))
+				continue;
+			dirty[i >> 5] &= ~(1U << (i & 31));
+			t->x = tx << FB_TILE_SIZE_LOG2;
+			t->y = ty << FB_TILE_SIZE_LOG2;
+			t->w = (t->x+FB_TILE_SIZE <= fb_width) ? FB_TILE_SIZE : fb_width-t->x;
+			t->h = (t->y+FB_TILE_SIZE <= fb_height) ? FB_TILE_SIZE : fb_height-t->y;
+			render(t);
+			fb_tile_flush(t);
+			fb_flush_rect(t->x, t->y, t->w, t->h);
+			n++;
+		}
+	}
+	return n;
+}
+
+// fills the part of a rectangle (in screen coordinates) that lies within
+// a tile, for use by render functions
+void fb_tile_fill_rect(fb_tile_t *t, int16_t x, int16_t y, uint16_t w, uint16_t h, uint32_t c)
+{
+	int16_t x1, y1, i;
+	uint32_t *p;
+
+	x1 = x+w;
+	y1 = y+h;
+	x -= t->x;
+	y -= t->y;
+	x1 -= t->x;
+	y1 -= t->y;
+	if (x < 0) x = 0;
+	if (y < 0) y = 0;
+	if (x1 > t->w) x1 = t->w;
+	if (y1 > t->h) y1 = t->h;
+	for (; y < y1; y++) {
+		p = &t->buf[(y << FB_TILE_SIZE_LOG2)];
+		for (i = x; i < x1; i++)
+			p[i] = c;
+	}
+}
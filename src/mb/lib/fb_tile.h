@@ -0,0 +1,40 @@
+/*******************************************************************************
+** fb_tile.h                                                                  **
+** Dirty tile tracking and tile based rendering for frame buffer.             **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#ifndef _FB_TILE_H_
+#define _FB_TILE_H_
+
+#include <stdint.h>
+
+#define FB_TILE_SIZE_LOG2 5
+#define FB_TILE_SIZE (1 << FB_TILE_SIZE_LOG2)
+
+typedef struct {
+	int16_t x;			// screen position of top left pixel
+	int16_t y;
+	uint16_t w;			// size (less than FB_TILE_SIZE at right and bottom edges)
+	uint16_t h;
+	uint32_t buf[FB_TILE_SIZE*FB_TILE_SIZE]; // pixels (FB_TILE_SIZE per row, in current format)
+} fb_tile_t;
+
+void fb_tile_init();
+void fb_tile_mark(int16_t x, int16_t y, uint16_t w, uint16_t h);
+void fb_tile_mark_all();
+uint16_t fb_tile_render(void (*render)(fb_tile_t *t));
+void fb_tile_fill_rect(fb_tile_t *t, int16_t x, int16_t y, uint16_t w, uint16_t h, uint32_t c);
+
+#endif
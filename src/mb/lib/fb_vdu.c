@@ -0,0 +1,338 @@
+/*******************************************************************************
+** fb_vdu.c                                                                   **
+** Text console on the frame buffer (implements the vdu.h API).               **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "fb.h"
+#include "fb_raster.h"
+#include "fb_copy.h"
+#include "font_437_8x16.h"
+#include "vdu.h"
+#include "vdu_term.h"
+
+// A drop in replacement for vdu.c (mb_display_sd) on the mb_fb frame
+// buffer, sharing its console state and escape sequence handling
+// (vdu_term.c). The character buffers (a character + attribute cell per
+// character, as vdu.c) are held in spare DDR after the palette; changes
+// to the console being shown are drawn at once with the CP437 8x16 font.
+// Glyph rows are expanded to pixels through small colour independent
+// tables of whole word masks (by nibble at 8 bpp, by bit pair at 16 bpp),
+// so any mix of attributes draws at the same speed. Scrolling moves the
+// frame buffer contents with fb_copy_rect() and draws just the new line.
+
+// pixel format (8 bpp draws fastest, and palette entries 0..15 are then
+// loaded with the exact CGA colours)
+#ifndef VDU_FMT
+#define VDU_FMT FB_FMT_8BPP
+#endif
+
+#define VDU_CHAR_W		8
+#define VDU_CHAR_H		16
+#define VDU_CELLS		FB_SPARE_BASE
+#define VDU_CON_SIZE	0x8000	// bytes per console (240 x 67 cells at 1920x1080)
+
+static uint32_t vdu_col[16];	// palette in the current format, repeated to fill 32 bits
+
+// CGA palette (as display_sd.vhd), byte 0 = red
+static const uint32_t vdu_cga[16] = {
+	0x000000, 0xAA0000, 0x00AA00, 0xAAAA00, 0x0000AA, 0xAA00AA, 0x0055AA, 0xAAAAAA,
+	0x555555, 0xFF5555, 0x55FF55, 0xFFFF55, 0x5555FF, 0xFF55FF, 0x55FFFF, 0xFFFFFF
+};
+
+// glyph row bits (bit 7 = leftmost pixel) to pixel masks
+static const uint32_t vdu_mask8[16] = { // 4 pixels per word
+	0x00000000, 0xFF000000, 0x00FF0000, 0xFFFF0000,
+	0x0000FF00, 0xFF00FF00, 0x00FFFF00, 0xFFFFFF00,
+	0x000000FF, 0xFF0000FF, 0x00FF00FF, 0xFFFF00FF,
+	0x0000FFFF, 0xFF00FFFF, 0x00FFFFFF, 0xFFFFFFFF
+};
+static const uint32_t vdu_mask16[4] = { // 2 pixels per word
+	0x00000000, 0xFFFF0000, 0x0000FFFF, 0xFFFFFFFF
+};
+
+#define CELL(i) (((volatile uint16_t *)vdu->buf)[i])
+#define SHOWN (vdu == &vdu_con[vdu_shown])
+
+// draws cell d (character in bits 7:0, attribute in bits 15:8) at (x,y)
+static void vdu_draw_cell(uint8_t x, uint8_t y, uint16_t d)
+{
+	const uint8_t *g = font_437_8x16 + ((d & 0xFF) * VDU_CHAR_H);
+	uint32_t fg = vdu_col[(d >> 8) & 0x0F];
+	uint32_t bg = vdu_col[d >> 12];
+	uint32_t k = fg ^ bg;
+	uint32_t pitch = fb_pitch << (2-fb_fmt);
+	uintptr_t a = fb_row[y*VDU_CHAR_H] + ((x*VDU_CHAR_W*4) >> fb_fmt);
+	FB_VOLATILE uint32_t *p;
+	uint8_t r, b;
+
+	switch(fb_fmt) {
+		case FB_FMT_8BPP:
+			for (r = 0; r < VDU_CHAR_H; r++, a += pitch) {
+				p = (FB_VOLATILE uint32_t *)a;
+				b = g[r];
+				p[0] = (vdu_mask8[b >> 4] & k) ^ bg;
+				p[1] = (vdu_mask8[b & 15] & k) ^ bg;
+			}
+			break;
+		case FB_FMT_16BPP:
+			for (r = 0; r < VDU_CHAR_H; r++, a += pitch) {
+				p = (FB_VOLATILE uint32_t *)a;
+				b = g[r];
+				p[0] = (vdu_mask16[b >> 6] & k) ^ bg;
+				p[1] = (vdu_mask16[(b >> 4) & 3] & k) ^ bg;
+				p[2] = (vdu_mask16[(b >> 2) & 3] & k) ^ bg;
+				p[3] = (vdu_mask16[b & 3] & k) ^ bg;
+			}
+			break;
+		default:
+			for (r = 0; r < VDU_CHAR_H; r++, a += pitch) {
+				p = (FB_VOLATILE uint32_t *)a;
+				b = g[r];
+				p[0] = (b & 0x80) ? fg : bg;
+				p[1] = (b & 0x40) ? fg : bg;
+				p[2] = (b & 0x20) ? fg : bg;
+				p[3] = (b & 0x10) ? fg : bg;
+				p[4] = (b & 0x08) ? fg : bg;
+				p[5] = (b & 0x04) ? fg : bg;
+				p[6] = (b & 0x02) ? fg : bg;
+				p[7] = (b & 0x01) ? fg : bg;
+			}
+	}
+}
+
+// writes back the text rows holding n cells from cell index i (cached mode)
+static void vdu_flush(uint16_t i, uint16_t n)
+{
+	uint8_t y0 = i / vdu_width;
+	uint8_t y1 = (i+n-1) / vdu_width;
+
+	fb_flush_rect(0, y0*VDU_CHAR_H, vdu_width*VDU_CHAR_W, (y1+1-y0)*VDU_CHAR_H);
+}
+
+// draws n cells from cell index i (row major) of the selected console, if shown
+static void vdu_draw(uint16_t i, uint16_t n)
+{
+	uint8_t x, y;
+	uint16_t j;
+
+	if (!SHOWN || !n)
+		return;
+	x = i % vdu_width;
+	y = i / vdu_width;
+	for (j = 0; j < n; j++) {
+		vdu_draw_cell(x, y, CELL(i+j));
+		if (++x == vdu_width) {
+			x = 0;
+			y++;
+		}
+	}
+	vdu_flush(i, n);
+}
+
+// draws n blank cells of attribute a from cell index i, if shown
+static void vdu_draw_blank(uint16_t i, uint16_t n, uint8_t a)
+{
+	uint16_t j, m, k;
+	uint8_t x, y, r;
+
+	if (!SHOWN || !n)
+		return;
+	for (j = i, m = n; m; j += k, m -= k) {
+		x = j % vdu_width;
+		y = j / vdu_width;
+		k = vdu_width-x < m ? vdu_width-x : m; // cells on this row
+		for (r = 0; r < VDU_CHAR_H; r++)
+			fb_span(x*VDU_CHAR_W, ((x+k)*VDU_CHAR_W)-1, (y*VDU_CHAR_H)+r, vdu_col[a >> 4]);
+	}
+	vdu_flush(i, n);
+}
+
+// returns 1 if character c has no pixels set
+static uint8_t vdu_blank(uint8_t c)
+{
+	const uint8_t *g = font_437_8x16 + (c * VDU_CHAR_H);
+	uint8_t r;
+
+	for (r = 0; r < VDU_CHAR_H; r++)
+		if (g[r])
+			return 0;
+	return 1;
+}
+
+// sets and draws n cells from cell index i to d
+static void vdu_fill_cells(uint16_t i, uint16_t n, uint16_t d)
+{
+	uint16_t j;
+
+	for (j = 0; j < n; j++)
+		CELL(i+j) = d;
+	if (vdu_blank(d & 0xFF))
+		vdu_draw_blank(i, n, d >> 8);
+	else
+		vdu_draw(i, n);
+}
+
+// the cell functions used by vdu_term.c (see vdu_term.h)
+
+void vdu_hal_put(uint8_t x, uint8_t y, uint16_t d)
+{
+	uint16_t i = x+(y*vdu_width);
+
+	CELL(i) = d;
+	vdu_draw(i, 1);
+}
+
+void vdu_hal_erase(uint16_t i, uint16_t n)
+{
+	vdu_fill_cells(i, n, vdu->attr << 8);
+}
+
+void vdu_hal_write(uint8_t x, uint8_t y, const char *s, uint8_t n)
+{
+	uint16_t i = x+(y*vdu_width);
+	uint16_t a = vdu->attr << 8;
+	uint8_t j;
+
+	for (j = 0; j < n; j++)
+		CELL(i+j) = a | (uint8_t)s[j];
+	vdu_draw(i, n);
+}
+
+// mode is a frame buffer mode (FB_MODE_xxx); the console is as many 8x16
+// characters as fit (e.g. 240x67 at 1920x1080, 80x30 at 640x480)
+void vdu_init(uint8_t mode)
+{
+	uint32_t c;
+	uint8_t i;
+
+	fb_init_fmt(mode, VDU_FMT);
+	for (i = 0; i < 16; i++) {
+		if (fb_fmt == FB_FMT_8BPP) { // the console owns the screen, so owns the palette
+			fb_set_pal(i, vdu_cga[i]);
+			c = i * 0x01010101;
+		}
+		else if (fb_fmt == FB_FMT_16BPP)
+			c = fb_rgb(vdu_cga[i]) * 0x00010001;
+		else
+			c = fb_rgb(vdu_cga[i]);
+		vdu_col[i] = c;
+	}
+	vdu_term_init(fb_width / VDU_CHAR_W, fb_height / VDU_CHAR_H, VDU_CELLS, VDU_CON_SIZE);
+}
+
+// display a console (redrawing the screen, so this takes effect at once)
+void vdu_show(uint8_t n)
+{
+	vdu_con_t *v = vdu;
+
+	if (n < VDU_CONSOLES) {
+		vdu_shown = n;
+		vdu = &vdu_con[n];
+		vdu_draw(0, vdu_width*vdu_height);
+		vdu = v;
+	}
+}
+
+void vdu_poke_char(uint8_t x, uint8_t y, uint8_t c)
+{
+	vdu_hal_put(x, y, (CELL(x+(y*vdu_width)) & 0xFF00) | c);
+}
+
+void vdu_poke_attr(uint8_t x, uint8_t y, uint8_t a)
+{
+	vdu_hal_put(x, y, (CELL(x+(y*vdu_width)) & 0x00FF) | (a << 8));
+}
+
+void vdu_poke_col_fg(uint8_t x, uint8_t y, uint8_t col)
+{
+	vdu_hal_put(x, y, (CELL(x+(y*vdu_width)) & 0xF0FF) | ((col & 0x0F) << 8));
+}
+
+void vdu_poke_col_bg(uint8_t x, uint8_t y, uint8_t col)
+{
+	vdu_hal_put(x, y, (CELL(x+(y*vdu_width)) & 0x0FFF) | ((col & 0x0F) << 12));
+}
+
+void vdu_poke_char_attr(uint8_t x, uint8_t y, uint8_t c, uint8_t a)
+{
+	vdu_hal_put(x, y, (a << 8) | c);
+}
+
+void vdu_fill_rect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t c, uint8_t a)
+{
+	if (!vdu_term_clip(x, y, &w, &h))
+		return;
+	if (w == vdu_width) { // whole rows are contiguous
+		vdu_fill_cells(y*vdu_width, w*h, (a << 8) | c);
+		return;
+	}
+	for (; h; h--, y++)
+		vdu_fill_cells(x+(y*vdu_width), w, (a << 8) | c);
+}
+
+void vdu_recol_rect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t a)
+{
+	uint16_t i;
+	uint8_t j;
+
+	if (!vdu_term_clip(x, y, &w, &h))
+		return;
+	for (; h; h--, y++) {
+		i = x+(y*vdu_width);
+		for (j = 0; j < w; j++)
+			CELL(i+j) = (CELL(i+j) & 0x00FF) | (a << 8);
+		vdu_draw(i, w);
+	}
+}
+
+// there is no border as such: the pixels beyond the last whole character
+// column and row are filled
+void vdu_set_border(uint8_t col)
+{
+	int16_t y;
+
+	for (y = 0; y < fb_height; y++)
+		fb_span(vdu_width*VDU_CHAR_W, fb_width-1, y, vdu_col[col & 0x0F]);
+	for (y = vdu_height*VDU_CHAR_H; y < fb_height; y++)
+		fb_span(0, fb_width-1, y, vdu_col[col & 0x0F]);
+	fb_flush();
+}
+
+// scroll the scroll region (whole screen by default) up by one line, moving
+// the pixels rather than redrawing them
+void vdu_scroll_up()
+{
+	uint8_t n = vdu->bottom-vdu->top;
+
+	memmove((void *)(vdu->buf+((vdu->top*vdu_width)<<1)), (void *)(vdu->buf+(((vdu->top+1)*vdu_width)<<1)), (vdu_width<<1)*n);
+	if (SHOWN)
+		fb_copy_rect(0, (vdu->top+1)*VDU_CHAR_H, vdu_width*VDU_CHAR_W, n*VDU_CHAR_H, 0, vdu->top*VDU_CHAR_H);
+	vdu_hal_erase(vdu->bottom*vdu_width, vdu_width);
+}
+
+// scroll the scroll region down by one line
+void vdu_scroll_down()
+{
+	uint8_t n = vdu->bottom-vdu->top;
+
+	memmove((void *)(vdu->buf+(((vdu->top+1)*vdu_width)<<1)), (void *)(vdu->buf+((vdu->top*vdu_width)<<1)), (vdu_width<<1)*n);
+	if (SHOWN)
+		fb_copy_rect(0, vdu->top*VDU_CHAR_H, vdu_width*VDU_CHAR_W, n*VDU_CHAR_H, 0, (vdu->top+1)*VDU_CHAR_H);
+	vdu_hal_erase(vdu->top*vdu_width, vdu_width);
+}
@@ -0,0 +1,25 @@
+/*******************************************************************************
+** font_437_8x16.h                                                            **
+** Code page 437 character set, 8x16 pixels (as char_rom_437_8x16.vhd).       **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#ifndef _FONT_437_8X16_H_
+#define _FONT_437_8X16_H_
+
+#include <stdint.h>
+
+extern const uint8_t font_437_8x16[256*16];
+
+#endif
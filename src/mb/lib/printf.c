@@ -29,69 +29,239 @@
  * OF SUCH DAMAGE.
  */
 
+#include <string.h>
+
 #include "printf.h"
 
+#ifdef PRINTF_LONG_LONG_SUPPORT
+#ifndef PRINTF_LONG_SUPPORT
+#define PRINTF_LONG_SUPPORT
+#endif
+#endif
+
 typedef void (*putcf) (void*,char);
+typedef void (*putwf) (void*,const char*,size_t);
 static putcf stdout_putf;
+static putwf stdout_putw;
 static void* stdout_putp;
+static tfp_sink* stdout_sink;
+
+#ifndef PRINTF_WRITE_BUFFER
+#define PRINTF_WRITE_BUFFER 32
+#endif
+
+/*
+ * Integer to ASCII conversion avoids division: hex digits are extracted
+ * by shifting, and decimal digits are produced two at a time from a
+ * table, dividing by 100 (or 10) with shifts and adds. This matters on
+ * CPUs without a hardware divider, where '/' and '%' are library calls.
+ * Digits are written backwards from the end of a scratch buffer.
+ */
+
+static const char dgt_pairs[200] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static unsigned int divu100(unsigned int n)
+	{
+	unsigned int q, r;
+	q = (n >> 1) + (n >> 3) + (n >> 6) - (n >> 10) + (n >> 12) + (n >> 13) - (n >> 16);
+	q = q + (q >> 20);
+	q = q >> 6;
+	r = n - ((q << 6) + (q << 5) + (q << 2));
+	return q + ((r + 28) >> 7);
+	}
+
+static char* u2dec(unsigned int num,char* p)
+	{
+	unsigned int q;
+	const char* d;
+	while (num>=100) {
+		q=divu100(num);
+		d=dgt_pairs+((num-((q << 6) + (q << 5) + (q << 2)))<<1);
+		*--p=d[1];
+		*--p=d[0];
+		num=q;
+		}
+	if (num>=10) {
+		d=dgt_pairs+(num<<1);
+		*--p=d[1];
+		*--p=d[0];
+		}
+	else
+		*--p='0'+num;
+	return p;
+	}
+
+static char* u2hex(unsigned int num,int uc,char* p)
+	{
+	const char* d=uc ? "0123456789ABCDEF" : "0123456789abcdef";
+	do {
+		*--p=d[num&15];
+		num>>=4;
+		} while (num);
+	return p;
+	}
+
+static void cpyz(char* bf,const char* p,const char* e)
+	{
+	while (p<e)
+		*bf++=*p++;
+	*bf=0;
+	}
+
+#ifdef PRINTF_LONG_LONG_SUPPORT
+
+static unsigned long long divu10ll(unsigned long long n)
+	{
+	unsigned long long q, r;
+	q = (n >> 1) + (n >> 2);
+	q = q + (q >> 4);
+	q = q + (q >> 8);
+	q = q + (q >> 16);
+	q = q + (q >> 32);
+	q = q >> 3;
+	r = n - (((q << 2) + q) << 1);
+	return q + (r > 9);
+	}
+
+static void ulli2a(unsigned long long num, unsigned int base, int uc,char * bf)
+	{
+	char tmp[24];
+	char* e=tmp+sizeof(tmp);
+	char* p=e;
+	unsigned long long q;
+	if (base==16) {
+		while (num>>32) {
+			*--p=(uc ? "0123456789ABCDEF" : "0123456789abcdef")[num&15];
+			num>>=4;
+			}
+		p=u2hex((unsigned int)num,uc,p);
+		}
+	else {
+		while (num>>32) {
+			q=divu10ll(num);
+			*--p='0'+(char)(num-((q << 3) + (q << 1)));
+			num=q;
+			}
+		p=u2dec((unsigned int)num,p);
+		}
+	cpyz(bf,p,e);
+	}
 
+static void lli2a (long long num, char * bf)
+	{
+	if (num<0) {
+		*bf++ = '-';
+		ulli2a(-(unsigned long long)num,10,0,bf);
+		}
+	else
+		ulli2a(num,10,0,bf);
+	}
+
+#endif
 
 #ifdef PRINTF_LONG_SUPPORT
 
+/* assumes long is 32 bits (as on MicroBlaze) unless long long is supported */
 static void uli2a(unsigned long int num, unsigned int base, int uc,char * bf)
 	{
-	int n=0;
-	unsigned int d=1;
-	while (num/d >= base)
-		d*=base;
-	while (d!=0) {
-		int dgt = num / d;
-		num%=d;
-		d/=base;
-		if (n || dgt>0|| d==0) {
-			*bf++ = dgt+(dgt<10 ? '0' : (uc ? 'A' : 'a')-10);
-			++n;
-			}
+	char tmp[12];
+	char* e=tmp+sizeof(tmp);
+#ifdef PRINTF_LONG_LONG_SUPPORT
+	if (sizeof(unsigned long int)>sizeof(unsigned int)) {
+		ulli2a(num,base,uc,bf);
+		return;
 		}
-	*bf=0;
+#endif
+	cpyz(bf,base==16 ? u2hex(num,uc,e) : u2dec(num,e),e);
 	}
 
 static void li2a (long num, char * bf)
 	{
 	if (num<0) {
-		num=-num;
 		*bf++ = '-';
+		uli2a(-(unsigned long int)num,10,0,bf);
 		}
-	uli2a(num,10,0,bf);
+	else
+		uli2a(num,10,0,bf);
 	}
 
 #endif
 
+/* base is 10 or 16 */
 static void ui2a(unsigned int num, unsigned int base, int uc,char * bf)
 	{
-	int n=0;
-	unsigned int d=1;
-	while (num/d >= base)
-		d*=base;
-	while (d!=0) {
-		int dgt = num / d;
-		num%= d;
-		d/=base;
-		if (n || dgt>0 || d==0) {
-			*bf++ = dgt+(dgt<10 ? '0' : (uc ? 'A' : 'a')-10);
-			++n;
-			}
-		}
-	*bf=0;
+	char tmp[12];
+	char* e=tmp+sizeof(tmp);
+	cpyz(bf,base==16 ? u2hex(num,uc,e) : u2dec(num,e),e);
 	}
 
 static void i2a (int num, char * bf)
 	{
 	if (num<0) {
-		num=-num;
 		*bf++ = '-';
+		ui2a(-(unsigned int)num,10,0,bf);
+		}
+	else
+		ui2a(num,10,0,bf);
+	}
+
+/*
+ * Fixed point to ASCII: 'fb' fractional bits (at most 16), 'prec'
+ * decimal places, rounded half up. Fraction digits are produced by
+ * multiplying the fraction by 10, so again no division is needed.
+ */
+static void q2a(int num,int fb,int prec,char* bf)
+	{
+	unsigned int m=num;
+	unsigned int mask=(1u<<fb)-1;
+	unsigned int f;
+	char* p;
+	if (num<0) {
+		m=-m;
+		*bf++='-';
+		}
+	f=m&mask;
+	m>>=fb;
+	if (prec==0 && (f>>(fb-1)))
+		m++;
+	ui2a(m,10,0,bf);
+	p=bf;
+	while (*p)
+		p++;
+	if (prec==0)
+		return;
+	*p++='.';
+	while (prec--) {
+		f*=10;
+		*p++='0'+(f>>fb);
+		f&=mask;
+		}
+	*p=0;
+	if (f>>(fb-1)) { /* round up: propagate carry leftwards */
+		char* q=p;
+		while (q>bf) {
+			q--;
+			if (*q=='.')
+				continue;
+			if (*q!='9') {
+				(*q)++;
+				return;
+				}
+			*q='0';
+			}
+		memmove(bf+1,bf,p-bf+1);
+		*bf='1';
 		}
-	ui2a(num,10,0,bf);
 	}
 
 static int a2d(char ch)
@@ -120,35 +290,61 @@ static char a2i(char ch, char** src,int base,int* nump)
 	return ch;
 	}
 
-static void putchw(void* putp,putcf putf,int n, char z, char* bf)
+static const char pad_spaces[]="                ";
+static const char pad_zeros[]="0000000000000000";
+
+static void putchw(void* putp,putwf putw,int n, char z, char* bf)
 	{
-	char fc=z? '0' : ' ';
-	char ch;
+	const char* fc=z? pad_zeros : pad_spaces;
 	char* p=bf;
-	while (*p++ && n > 0)
+	if (z && *bf=='-') { /* sign goes before zero padding */
+		putw(putp,bf++,1);
 		n--;
-	while (n-- > 0)
-		putf(putp,fc);
-	while ((ch= *bf++))
-		putf(putp,ch);
+		}
+	while (*p)
+		p++;
+	n-=p-bf;
+	while (n > 0) {
+		int m=n < (int)sizeof(pad_spaces)-1 ? n : (int)sizeof(pad_spaces)-1;
+		putw(putp,fc,m);
+		n-=m;
+		}
+	putw(putp,bf,p-bf);
 	}
 
-void tfp_format(void* putp,putcf putf,char *fmt, va_list va)
+/*
+ * The formatter emits spans: each literal run of the format string, each
+ * block of padding and each converted argument goes out in one call to
+ * 'putw'.
+ */
+static void tfp_vformat(void* putp,putwf putw,char *fmt, va_list va)
 	{
-	char bf[12];
+#ifdef PRINTF_LONG_LONG_SUPPORT
+	char bf[24];
+#else
+	char bf[20];
+#endif
 
 	char ch;
+	char* lit;
 
 
-	while ((ch=*(fmt++))) {
-		if (ch!='%')
-			putf(putp,ch);
+	while ((ch=*fmt)) {
+		if (ch!='%') {
+			lit=fmt;
+			while (*fmt && *fmt!='%')
+				fmt++;
+			putw(putp,lit,fmt-lit);
+			}
 		else {
 			char lz=0;
 #ifdef 	PRINTF_LONG_SUPPORT
 			char lng=0;
 #endif
+			char sht=0;
 			int w=0;
+			int prec=-1;
+			fmt++;
 			ch=*(fmt++);
 			if (ch=='0') {
 				ch=*(fmt++);
@@ -157,52 +353,95 @@ void tfp_format(void* putp,putcf putf,char *fmt, va_list va)
 			if (ch>='0' && ch<='9') {
 				ch=a2i(ch,&fmt,10,&w);
 				}
+			if (ch=='.') {
+				ch=*(fmt++);
+				prec=0;
+				if (ch>='0' && ch<='9')
+					ch=a2i(ch,&fmt,10,&prec);
+				}
+			if (ch=='h') {
+				ch=*(fmt++);
+				sht=1;
+				}
 #ifdef 	PRINTF_LONG_SUPPORT
 			if (ch=='l') {
 				ch=*(fmt++);
 				lng=1;
+#ifdef 	PRINTF_LONG_LONG_SUPPORT
+				if (ch=='l') {
+					ch=*(fmt++);
+					lng=2;
+					}
+#endif
 			}
 #endif
 			switch (ch) {
 				case 0:
 					goto abort;
 				case 'u' : {
+#ifdef 	PRINTF_LONG_LONG_SUPPORT
+					if (lng==2)
+						ulli2a(va_arg(va, unsigned long long int),10,0,bf);
+					else
+#endif
 #ifdef 	PRINTF_LONG_SUPPORT
 					if (lng)
 						uli2a(va_arg(va, unsigned long int),10,0,bf);
 					else
 #endif
 					ui2a(va_arg(va, unsigned int),10,0,bf);
-					putchw(putp,putf,w,lz,bf);
+					putchw(putp,putw,w,lz,bf);
 					break;
 					}
 				case 'd' :  {
+#ifdef 	PRINTF_LONG_LONG_SUPPORT
+					if (lng==2)
+						lli2a(va_arg(va, long long int),bf);
+					else
+#endif
 #ifdef 	PRINTF_LONG_SUPPORT
 					if (lng)
 						li2a(va_arg(va, unsigned long int),bf);
 					else
 #endif
 					i2a(va_arg(va, int),bf);
-					putchw(putp,putf,w,lz,bf);
+					putchw(putp,putw,w,lz,bf);
 					break;
 					}
 				case 'x': case 'X' :
+#ifdef 	PRINTF_LONG_LONG_SUPPORT
+					if (lng==2)
+						ulli2a(va_arg(va, unsigned long long int),16,(ch=='X'),bf);
+					else
+#endif
 #ifdef 	PRINTF_LONG_SUPPORT
 					if (lng)
 						uli2a(va_arg(va, unsigned long int),16,(ch=='X'),bf);
 					else
 #endif
 					ui2a(va_arg(va, unsigned int),16,(ch=='X'),bf);
-					putchw(putp,putf,w,lz,bf);
+					putchw(putp,putw,w,lz,bf);
+					break;
+				case 'q' :
+					if (prec<0)
+						prec=4;
+					else if (prec>9)
+						prec=9;
+					if (sht)
+						q2a((short)va_arg(va, int),15,prec,bf);
+					else
+						q2a(va_arg(va, int),16,prec,bf);
+					putchw(putp,putw,w,lz,bf);
 					break;
 				case 'c' :
-					putf(putp,(char)(va_arg(va, int)));
+					bf[0]=(char)(va_arg(va, int));
+					putw(putp,bf,1);
 					break;
 				case 's' :
-					putchw(putp,putf,w,0,va_arg(va, char*));
+					putchw(putp,putw,w,0,va_arg(va, char*));
 					break;
 				case '%' :
-					putf(putp,ch);
+					putw(putp,fmt-1,1);
 				default:
 					break;
 				}
@@ -211,35 +450,184 @@ void tfp_format(void* putp,putcf putf,char *fmt, va_list va)
 	abort:;
 	}
 
+/* character output function adapter, for tfp_format */
+typedef struct {
+	void* putp;
+	putcf putf;
+	} putcw_t;
+
+static void putcw(void* p,const char* s,size_t n)
+	{
+	putcw_t* c=(putcw_t*)p;
+	while (n--)
+		c->putf(c->putp,*s++);
+	}
+
+void tfp_format(void* putp,putcf putf,char *fmt, va_list va)
+	{
+	putcw_t c;
+	c.putp=putp;
+	c.putf=putf;
+	tfp_vformat(&c,putcw,fmt,va);
+	}
+
+void tfp_sink_init(tfp_sink* sink,void* putp,void (*putw) (void*,const char*,size_t),char* bf,size_t size)
+	{
+	sink->putp=putp;
+	sink->putw=putw;
+	sink->bf=bf;
+	sink->size=bf ? size : 0;
+	sink->n=0;
+	sink->next=0;
+	}
+
+void tfp_sink_tee(tfp_sink* sink,tfp_sink* next)
+	{
+	while (sink->next)
+		sink=sink->next;
+	sink->next=next;
+	}
+
+void tfp_sink_write(tfp_sink* sink,const char* s,size_t n)
+	{
+	if (!n) /* nothing to do (and an unbuffered sink has no bf to copy to) */
+		return;
+	for (; sink; sink=sink->next) {
+		if (sink->n+n > sink->size) {
+			if (sink->n) {
+				sink->putw(sink->putp,sink->bf,sink->n);
+				sink->n=0;
+				}
+			if (n >= sink->size) { /* too big to buffer */
+				sink->putw(sink->putp,s,n);
+				continue;
+				}
+			}
+		memcpy(sink->bf+sink->n,s,n);
+		sink->n+=n;
+		}
+	}
+
+void tfp_sink_flush(tfp_sink* sink)
+	{
+	for (; sink; sink=sink->next) {
+		if (sink->n) {
+			sink->putw(sink->putp,sink->bf,sink->n);
+			sink->n=0;
+			}
+		}
+	}
+
+static void putsink(void* p,const char* s,size_t n)
+	{
+	tfp_sink_write((tfp_sink*)p,s,n);
+	}
+
+void tfp_sink_format(tfp_sink* sink,char *fmt, va_list va)
+	{
+	tfp_vformat(sink,putsink,fmt,va);
+	}
+
+void tfp_fprintf(tfp_sink* sink,char *fmt, ...)
+	{
+	va_list va;
+	va_start(va,fmt);
+	tfp_vformat(sink,putsink,fmt,va);
+	tfp_sink_flush(sink);
+	va_end(va);
+	}
 
 void init_printf(void* putp,void (*putf) (void*,char))
 	{
 	stdout_putf=putf;
+	stdout_putw=0;
+	stdout_sink=0;
 	stdout_putp=putp;
 	}
 
+void init_printf_write(void* putp,void (*putw) (void*,const char*,size_t))
+	{
+	stdout_putw=putw;
+	stdout_sink=0;
+	stdout_putp=putp;
+	}
+
+void init_printf_sink(tfp_sink* sink)
+	{
+	stdout_sink=sink;
+	}
+
 void tfp_printf(char *fmt, ...)
 	{
 	va_list va;
 	va_start(va,fmt);
-	tfp_format(stdout_putp,stdout_putf,fmt,va);
+	if (stdout_sink) {
+		tfp_vformat(stdout_sink,putsink,fmt,va);
+		tfp_sink_flush(stdout_sink);
+		}
+	else if (stdout_putw) { /* buffer on the stack, so still re-entrant */
+		tfp_sink sink;
+		char bf[PRINTF_WRITE_BUFFER];
+		tfp_sink_init(&sink,stdout_putp,stdout_putw,bf,sizeof(bf));
+		tfp_vformat(&sink,putsink,fmt,va);
+		tfp_sink_flush(&sink);
+		}
+	else
+		tfp_format(stdout_putp,stdout_putf,fmt,va);
 	va_end(va);
 	}
 
-static void putcp(void* p,char c)
+static void putsp(void* p,const char* s,size_t n)
 	{
-	*(*((char**)p))++ = c;
+	memcpy(*((char**)p),s,n);
+	*((char**)p)+=n;
 	}
 
 
 
-void tfp_sprintf(char* s,char *fmt, ...)
+typedef struct {
+	char* p;
+	size_t room;
+	size_t len;
+	} snbuf;
+
+static void putsn(void* p,const char* s,size_t n)
+	{
+	snbuf* b=(snbuf*)p;
+	size_t m=n < b->room ? n : b->room;
+	memcpy(b->p,s,m);
+	b->p+=m;
+	b->room-=m;
+	b->len+=n;
+	}
+
+int tfp_vsnprintf(char* s,size_t n,char *fmt, va_list va)
+	{
+	snbuf b;
+	b.p=s;
+	b.room=n ? n-1 : 0;
+	b.len=0;
+	tfp_vformat(&b,putsn,fmt,va);
+	if (n)
+		*b.p=0;
+	return b.len;
+	}
+
+int tfp_snprintf(char* s,size_t n,char *fmt, ...)
 	{
+	int r;
 	va_list va;
 	va_start(va,fmt);
-	tfp_format(&s,putcp,fmt,va);
-	putcp(&s,0);
+	r=tfp_vsnprintf(s,n,fmt,va);
 	va_end(va);
+	return r;
 	}
 
-
+void tfp_sprintf(char* s,char *fmt, ...)
+	{
+	va_list va;
+	va_start(va,fmt);
+	tfp_vformat(&s,putsp,fmt,va);
+	*s=0;
+	va_end(va);
+	}
@@ -43,17 +43,38 @@ debugger at all.
 They are distributed in source form, so to use them, just compile them
 into your project.
 
-Two printf variants are provided: printf and sprintf.
+Three printf variants are provided: printf, sprintf and snprintf.
 
-The formats supported by this implementation are: 'd' 'u' 'c' 's' 'x' 'X'.
+The formats supported by this implementation are: 'd' 'u' 'c' 's' 'x' 'X'
+and 'q'.
 
 Zero padding and field width are also supported.
 
+'q' prints a signed fixed point number: a Q16.16 'int' by default, or a
+Q15 'short' with the 'h' modifier ('%hq'). The precision gives the
+number of decimal places (default 4, maximum 9, '%.0q' rounds to an
+integer), e.g. '%8.3q' prints 0x00018000 as "   1.500". No floating
+point code is pulled in.
+
+Zero padding goes between the sign and the digits, for 'q' as for 'd',
+e.g. '%08.3q' prints -1.5 (0xFFFE8000) as "-001.500".
+
+'snprintf' (and 'tfp_vsnprintf') never write more than the given size
+including the terminating zero, and return the length the output would
+have had, so a return value of 'size' or more means it was truncated.
+
 If the library is compiled with 'PRINTF_SUPPORT_LONG' defined then the
 long specifier is also
 supported. Note that this will pull in some long math routines (pun intended!)
 and thus make your executable noticably longer.
 
+If the library is compiled with 'PRINTF_LONG_LONG_SUPPORT' defined then
+the long long specifier ('ll', e.g. '%llu' '%lld' '%llx') is also
+supported; this implies 'PRINTF_LONG_SUPPORT'.
+
+Numbers are converted without division instructions (shifts, adds and
+a table of digit pairs), which suits CPUs without a hardware divider.
+
 The memory foot print of course depends on the target cpu, compiler and
 compiler options, but a rough guestimate (based on a H8S target) is about
 1.4 kB for code and some twenty 'int's and 'char's, say 60 bytes of stack space.
@@ -97,6 +118,32 @@ Without variadic macros this is the best we can do to wrap these
 fucnction. If it is a problem just give up the macros and use the
 functions directly or rename them.
 
+If your output device can accept a block of characters more efficiently
+than one at a time, you can also supply a write function after
+'init_printf':
+
+init_printf_write(NULL,putw);
+
+'printf' then collects its output in a small buffer on the stack (see
+PRINTF_WRITE_BUFFER) and passes it to 'putw' in blocks. Calling
+'init_printf' again reverts to character output.
+
+More generally, output can go to one or more sinks, each with its own
+write function and buffer:
+
+static char vdu_bf[64], uart_bf[16];
+tfp_sink vdu, uart;
+tfp_sink_init(&vdu,NULL,vdu_putw,vdu_bf,sizeof(vdu_bf));
+tfp_sink_init(&uart,NULL,uart_putw,uart_bf,sizeof(uart_bf));
+tfp_sink_tee(&vdu,&uart);
+init_printf_sink(&vdu);
+
+Literal text and converted numbers are passed to the sinks as spans,
+not character by character, and each 'printf' (or 'tfp_fprintf') call
+flushes the sinks when it completes. A sink with no buffer passes spans
+straight through. Note that a shared sink buffer makes 'printf' non
+re-entrant for that sink.
+
 For further details see source code.
 
 regs Kusti, 23.10.2004
@@ -107,16 +154,40 @@ regs Kusti, 23.10.2004
 #define __TFP_PRINTF__
 
 #include <stdarg.h>
+#include <stddef.h>
+
+/* buffered output sink; sinks may be chained to tee output to several devices */
+typedef struct tfp_sink {
+	void* putp;
+	void (*putw) (void*,const char*,size_t);
+	char* bf;
+	size_t size;
+	size_t n;
+	struct tfp_sink* next;
+	} tfp_sink;
 
 void init_printf(void* putp,void (*putf) (void*,char));
+void init_printf_write(void* putp,void (*putw) (void*,const char*,size_t));
+void init_printf_sink(tfp_sink* sink);
+
+void tfp_sink_init(tfp_sink* sink,void* putp,void (*putw) (void*,const char*,size_t),char* bf,size_t size);
+void tfp_sink_tee(tfp_sink* sink,tfp_sink* next);
+void tfp_sink_write(tfp_sink* sink,const char* s,size_t n);
+void tfp_sink_flush(tfp_sink* sink);
+void tfp_sink_format(tfp_sink* sink,char *fmt, va_list va);
+void tfp_fprintf(tfp_sink* sink,char *fmt, ...);
 
 void tfp_printf(char *fmt, ...);
 void tfp_sprintf(char* s,char *fmt, ...);
+int tfp_snprintf(char* s,size_t n,char *fmt, ...);
+int tfp_vsnprintf(char* s,size_t n,char *fmt, va_list va);
 
 void tfp_format(void* putp,void (*putf) (void*,char),char *fmt, va_list va);
 
 #define printf tfp_printf
 #define sprintf tfp_sprintf
+#define snprintf tfp_snprintf
+#define vsnprintf tfp_vsnprintf
 
 #endif
 
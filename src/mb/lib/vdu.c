@@ -26,38 +26,94 @@
 #include "axi_gpio.h"
 #include "printf.h"
 #include "vdu.h"
+#include "vdu_term.h"
 
-static uint8_t vdu_width = 0;
-static uint8_t vdu_height = 0;
-static uint8_t vdu_x = 0;
-static uint8_t vdu_y = 0;
-static uint8_t vdu_attr = 0x0F;
-
-#define POKE_CHAR(x,y,c) poke8(VDU_BUF+((x+(y*vdu_width))<<1),c)
-#define PEEK_CHAR(x,y) peek8(VDU_BUF+((x+(y*vdu_width))<<1))
-#define POKE_ATTR(x,y,a) poke8(VDU_BUF+((x+(y*vdu_width))<<1)+1,a)
-#define PEEK_ATTR(x,y) peek8(VDU_BUF+((x+(y*vdu_width))<<1)+1)
+#define POKE_CHAR(x,y,c) poke8(vdu->buf+((x+(y*vdu_width))<<1),c)
+#define PEEK_CHAR(x,y) peek8(vdu->buf+((x+(y*vdu_width))<<1))
+#define POKE_ATTR(x,y,a) poke8(vdu->buf+((x+(y*vdu_width))<<1)+1,a)
+#define PEEK_ATTR(x,y) peek8(vdu->buf+((x+(y*vdu_width))<<1)+1)
 #define POKE_COL_FG(x,y,col) POKE_ATTR(x,y,(PEEK_ATTR(x,y) & 0xF0)|(col & 0x0F))
 #define POKE_COL_BG(x,y,col) POKE_ATTR(x,y,(PEEK_ATTR(x,y) & 0x0F)|((col & 0x0F)<<4))
-#define POKE_CHAR_ATTR(x,y,c,a) poke16(VDU_BUF+((x+(y*vdu_width))<<1),(a << 8)|c)
+#define POKE_CHAR_ATTR(x,y,c,a) poke16(vdu->buf+((x+(y*vdu_width))<<1),(a << 8)|c)
+#define CELL_PTR(x,y) ((volatile uint16_t *)(vdu->buf+((x+(y*vdu_width))<<1)))
+
+// fill n contiguous cells from p with d (char+attr), 2 cells per 32 bit write
+static void vdu_fill_cells(volatile uint16_t *p, uint16_t n, uint16_t d)
+{
+	volatile uint32_t *p2;
+	uint32_t d2;
+
+	if (n && ((uintptr_t)p & 2)) {
+		*p++ = d;
+		n--;
+	}
+	p2 = (volatile uint32_t *)p;
+	d2 = d | ((uint32_t)d << 16);
+	while (n >= 8) {
+		p2[0] = d2;
+		p2[1] = d2;
+		p2[2] = d2;
+		p2[3] = d2;
+		p2 += 4;
+		n -= 8;
+	}
+	while (n >= 2) {
+		*p2++ = d2;
+		n -= 2;
+	}
+	if (n)
+		*(volatile uint16_t *)p2 = d;
+}
+
+// set the attribute of n contiguous cells from p, leaving characters unchanged
+static void vdu_recol_cells(volatile uint16_t *p, uint16_t n, uint8_t a)
+{
+	volatile uint32_t *p2;
+	uint32_t a2;
+
+	if (n && ((uintptr_t)p & 2)) {
+		*((volatile uint8_t *)p++ + 1) = a;
+		n--;
+	}
+	p2 = (volatile uint32_t *)p;
+	a2 = (a << 8) | ((uint32_t)a << 24);
+	while (n >= 2) {
+		*p2 = (*p2 & 0x00FF00FF) | a2;
+		p2++;
+		n -= 2;
+	}
+	if (n)
+		*((volatile uint8_t *)p2 + 1) = a;
+}
+
+// the cell functions used by vdu_term.c (see vdu_term.h)
+
+void vdu_hal_erase(uint16_t i, uint16_t n)
+{
+	vdu_fill_cells((volatile uint16_t *)(vdu->buf+(i<<1)), n, vdu->attr << 8);
+}
 
 void vdu_init(uint8_t mode)
 {
 	uint32_t r;
-	uint8_t x, y;
 
 	r = axi_gpio_get_gpi(0);
-	r = (r & ~1) | (mode & 1);
+	r = (r & ~7) | (mode & 1);
 	axi_gpio_set_gpo(0, r);
-	vdu_width = 80;
-	vdu_height = mode ? 32 : 25;
-	vdu_x = 0;
-	vdu_y = 0;
-	vdu_attr = 0x0F;
-	for (x = 0; x < vdu_width; x++)
-		for (y = 0; y < vdu_height; y++)
-			POKE_CHAR_ATTR(x,y,0,vdu_attr);
-    init_printf(NULL,vdu_putc);
+	vdu_term_init(80, mode ? 32 : 25, VDU_BUF, VDU_PAGE_SIZE);
+}
+
+// display a console; takes effect at the next vertical sync
+void vdu_show(uint8_t n)
+{
+	uint32_t r;
+
+	if (n < VDU_CONSOLES) {
+		vdu_shown = n;
+		r = axi_gpio_get_gpi(0);
+		r = (r & ~6) | (n << 1);
+		axi_gpio_set_gpo(0, r);
+	}
 }
 
 void vdu_poke_char(uint8_t x, uint8_t y, uint8_t c)
@@ -85,10 +141,28 @@ void vdu_poke_char_attr(uint8_t x, uint8_t y, uint8_t c, uint8_t a)
 	POKE_CHAR_ATTR(x,y,c,a);
 }
 
-void vdu_set_pos(uint8_t x, uint8_t y)
+void vdu_fill_rect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t c, uint8_t a)
+{
+	volatile uint16_t *p;
+
+	if (!vdu_term_clip(x, y, &w, &h))
+		return;
+	if (w == vdu_width) { // whole rows are contiguous
+		vdu_fill_cells(CELL_PTR(0,y), w*h, (a << 8) | c);
+		return;
+	}
+	for (p = CELL_PTR(x,y); h; h--, p += vdu_width)
+		vdu_fill_cells(p, w, (a << 8) | c);
+}
+
+void vdu_recol_rect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t a)
 {
-	vdu_x = x;
-	vdu_y = y;
+	volatile uint16_t *p;
+
+	if (!vdu_term_clip(x, y, &w, &h))
+		return;
+	for (p = CELL_PTR(x,y); h; h--, p += vdu_width)
+		vdu_recol_cells(p, w, a);
 }
 
 void vdu_set_border(uint8_t col)
@@ -100,57 +174,45 @@ void vdu_set_border(uint8_t col)
 	axi_gpio_set_gpo(0, r);
 }
 
-void vdu_set_attr(uint8_t attr)
-{
-	vdu_attr = attr;
-}
-
-void vdu_set_col(uint8_t fg, uint8_t bg)
-{
-	vdu_attr = ((bg & 0x0F) << 4) | (fg & 0x0F);
-}
-
-void vdu_set_col_fg(uint8_t col)
+// scroll the scroll region (whole screen by default) up by one line
+void vdu_scroll_up()
 {
-	vdu_attr = (vdu_attr & 0xF0) | (col & 0x0F);
+	Xil_MemCpy((void *)(vdu->buf+((vdu->top*vdu_width)<<1)), (void *)(vdu->buf+(((vdu->top+1)*vdu_width)<<1)), (vdu_width<<1)*(vdu->bottom-vdu->top));
+	vdu_hal_erase(vdu->bottom*vdu_width, vdu_width);
 }
 
-void vdu_set_col_bg(uint8_t col)
+// scroll the scroll region down by one line
+void vdu_scroll_down()
 {
-	vdu_attr = (vdu_attr & 0x0F) | ((col & 0x0F) << 4);
-}
+	uint8_t y;
 
-void vdu_scroll_up()
-{
-	Xil_MemCpy((void *)VDU_BUF, (void *)(VDU_BUF+(vdu_width<<1)), (vdu_width<<1)*(vdu_height-1));
-	memset((void *)VDU_BUF+((vdu_width<<1)*(vdu_height-1)), 0, (size_t)(vdu_width<<1));
+	for (y = vdu->bottom; y > vdu->top; y--)
+		Xil_MemCpy((void *)(vdu->buf+((y*vdu_width)<<1)), (void *)(vdu->buf+(((y-1)*vdu_width)<<1)), vdu_width<<1);
+	vdu_hal_erase(vdu->top*vdu_width, vdu_width);
 }
 
-void vdu_newline()
+void vdu_hal_put(uint8_t x, uint8_t y, uint16_t d)
 {
-	vdu_x = 0;
-	if (++vdu_y == vdu_height) {
-		vdu_y--;
-		vdu_scroll_up();
-	}
+	*CELL_PTR(x,y) = d;
 }
 
-void vdu_putc(void *p, char c)
+void vdu_hal_write(uint8_t x, uint8_t y, const char *s, uint8_t n)
 {
-	if (c >= 32) { // display characters 32..255
-		POKE_CHAR_ATTR(vdu_x++, vdu_y, c, vdu_attr);
-		if (vdu_x == vdu_width) {
-			vdu_newline();
-		}
+	volatile uint16_t *p;
+	uint16_t a;
+
+	p = CELL_PTR(x, y);
+	a = vdu->attr << 8;
+	if (n && ((uintptr_t)p & 2)) {
+		*p++ = a | (uint8_t)*s++;
+		n--;
 	}
-	else { // control characters 0..31
-		switch(c) {
-			case 10 :	// newline
-				vdu_newline();
-				break;
-			case 13 :	// CR
-				vdu_x = 0;
-				break;
-		}
+	while (n >= 2) { // 2 cells (char+attr pairs) per 32 bit write
+		*(volatile uint32_t *)p = (a | (uint8_t)s[0]) | ((uint32_t)(a | (uint8_t)s[1]) << 16);
+		p += 2;
+		s += 2;
+		n -= 2;
 	}
+	if (n)
+		*p = a | (uint8_t)*s;
 }
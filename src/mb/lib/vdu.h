@@ -18,10 +18,16 @@
 #ifndef _VDU_H_
 #define _VDU_H_
 
+#include <stddef.h>
+
 #include "printf.h"
 
+#ifndef FB_HOST // host build of fb_vdu.c
 #include "xparameters.h"
 #define VDU_BUF	XPAR_BRAM_S_AXI_BASEADDR
+#endif
+#define VDU_PAGE_SIZE	0x2000	// 8kBytes per console
+#define VDU_CONSOLES	4
 
 #define VDU_BLACK			0x0
 #define VDU_BLUE			0x1
@@ -41,11 +47,19 @@
 #define VDU_WHITE			0xF
 
 void vdu_init(uint8_t mode);
+void vdu_select(uint8_t n);
+void vdu_show(uint8_t n);
+uint8_t vdu_get_selected();
+uint8_t vdu_get_shown();
 void vdu_poke_char(uint8_t x, uint8_t y, uint8_t c);
 void vdu_poke_attr(uint8_t x, uint8_t y, uint8_t a);
 void vdu_poke_col_fg(uint8_t x, uint8_t y, uint8_t col);
 void vdu_poke_col_bg(uint8_t x, uint8_t y, uint8_t col);
 void vdu_poke_char_attr(uint8_t x, uint8_t y, uint8_t c, uint8_t a);
+void vdu_fill_rect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t c, uint8_t a);
+void vdu_clear_rect(uint8_t x, uint8_t y, uint8_t w, uint8_t h);
+void vdu_recol_rect(uint8_t x, uint8_t y, uint8_t w, uint8_t h, uint8_t a);
+void vdu_clear();
 void vdu_set_pos(uint8_t x, uint8_t y);
 void vdu_set_border(uint8_t col);
 void vdu_set_attr(uint8_t attr);
@@ -53,7 +67,11 @@ void vdu_set_col(uint8_t fg, uint8_t bg);
 void vdu_set_col_fg(uint8_t col);
 void vdu_set_col_bg(uint8_t col);
 void vdu_scroll_up();
+void vdu_scroll_down();
 void vdu_newline();
 void vdu_putc(void *p, char c);
+void vdu_write(const char *s, size_t n);
+void vdu_puts(const char *s);
+void vdu_putw(void *p, const char *s, size_t n);
 
 #endif
@@ -0,0 +1,399 @@
+/*******************************************************************************
+** vdu_term.c                                                                 **
+** Console state and escape sequence handling shared by VDU drivers.          **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#include <string.h>
+#include <stdint.h>
+
+#include "printf.h"
+#include "vdu.h"
+#include "vdu_term.h"
+
+vdu_con_t vdu_con[VDU_CONSOLES];
+vdu_con_t *vdu = &vdu_con[0];
+uint8_t vdu_shown = 0;
+uint8_t vdu_width = 0;
+uint8_t vdu_height = 0;
+
+#define ATTR_SWAP(a) ((uint8_t)(((a) << 4) | ((a) >> 4)))
+
+// ANSI colour number to VDU (CGA) palette
+static const uint8_t vdu_ansi_col[8] = {
+	VDU_BLACK, VDU_RED, VDU_GREEN, VDU_BROWN,
+	VDU_BLUE, VDU_MAGENTA, VDU_CYAN, VDU_LIGHT_GRAY
+};
+
+// sets up the consoles, each with a character buffer page of page_size
+// bytes from buf, and directs printf output to the selected console
+void vdu_term_init(uint8_t width, uint8_t height, uintptr_t buf, uint32_t page_size)
+{
+	uint8_t i;
+
+	vdu_width = width;
+	vdu_height = height;
+	vdu_shown = 0;
+	for (i = 0; i < VDU_CONSOLES; i++) {
+		vdu = &vdu_con[i];
+		memset(vdu, 0, sizeof(vdu_con_t));
+		vdu->buf = buf+(i*page_size);
+		vdu->attr = 0x0F;
+		vdu->attr_def = vdu->attr;
+		vdu->saved_attr = vdu->attr;
+		vdu->bottom = vdu_height-1;
+		vdu->esc = ESC_NONE;
+		vdu_hal_erase(0, vdu_width*vdu_height);
+	}
+	vdu = &vdu_con[0];
+	init_printf(NULL,vdu_putc);
+	init_printf_write(NULL,vdu_putw);
+}
+
+// clip a rectangle to the screen; returns 0 if nothing is left
+uint8_t vdu_term_clip(uint8_t x, uint8_t y, uint8_t *w, uint8_t *h)
+{
+	if (x >= vdu_width || y >= vdu_height)
+		return 0;
+	if (*w > vdu_width-x)
+		*w = vdu_width-x;
+	if (*h > vdu_height-y)
+		*h = vdu_height-y;
+	return *w && *h;
+}
+
+// direct output (printf, vdu_putc, vdu_set_*, vdu_poke_* etc) to a console
+void vdu_select(uint8_t n)
+{
+	if (n < VDU_CONSOLES)
+		vdu = &vdu_con[n];
+}
+
+uint8_t vdu_get_selected()
+{
+	return vdu - vdu_con;
+}
+
+uint8_t vdu_get_shown()
+{
+	return vdu_shown;
+}
+
+void vdu_clear_rect(uint8_t x, uint8_t y, uint8_t w, uint8_t h)
+{
+	vdu_fill_rect(x, y, w, h, 0, vdu->attr);
+}
+
+void vdu_clear()
+{
+	vdu_hal_erase(0, vdu_width*vdu_height);
+	vdu->x = 0;
+	vdu->y = 0;
+}
+
+void vdu_set_pos(uint8_t x, uint8_t y)
+{
+	vdu->x = x;
+	vdu->y = y;
+}
+
+void vdu_set_attr(uint8_t attr)
+{
+	vdu->attr = attr;
+	vdu->attr_def = vdu->attr;
+	vdu->rev = 0;
+}
+
+void vdu_set_col(uint8_t fg, uint8_t bg)
+{
+	vdu->attr = ((bg & 0x0F) << 4) | (fg & 0x0F);
+	vdu->attr_def = vdu->attr;
+	vdu->rev = 0;
+}
+
+void vdu_set_col_fg(uint8_t col)
+{
+	vdu->attr = (vdu->attr & 0xF0) | (col & 0x0F);
+	vdu->attr_def = vdu->attr;
+	vdu->rev = 0;
+}
+
+void vdu_set_col_bg(uint8_t col)
+{
+	vdu->attr = (vdu->attr & 0x0F) | ((col & 0x0F) << 4);
+	vdu->attr_def = vdu->attr;
+	vdu->rev = 0;
+}
+
+// move down one line, scrolling if at the bottom of the scroll region
+static void vdu_index()
+{
+	if (vdu->y == vdu->bottom)
+		vdu_scroll_up();
+	else if (vdu->y < vdu_height-1)
+		vdu->y++;
+}
+
+// move up one line, scrolling if at the top of the scroll region
+static void vdu_reverse_index()
+{
+	if (vdu->y == vdu->top)
+		vdu_scroll_down();
+	else if (vdu->y > 0)
+		vdu->y--;
+}
+
+void vdu_newline()
+{
+	vdu->x = 0;
+	vdu_index();
+}
+
+// SGR (select graphic rendition): ANSI colours are mapped to the VDU palette,
+// bold selects the bright half of the palette; reverse video is a state
+// (SGR 7 sets it, SGR 27 clears it) applied once to the resulting colours
+static void vdu_sgr()
+{
+	uint8_t i, p;
+	uint8_t a = vdu->rev ? ATTR_SWAP(vdu->attr) : vdu->attr;
+
+	for (i = 0; i <= vdu->csi_n; i++) {
+		p = vdu->csi_p[i];
+		if (p == 0) {
+			a = vdu->attr_def;
+			vdu->rev = 0;
+		}
+		else if (p == 1)
+			a |= 0x08;
+		else if (p == 22)
+			a &= ~0x08;
+		else if (p == 7)
+			vdu->rev = 1;
+		else if (p == 27)
+			vdu->rev = 0;
+		else if (p >= 30 && p <= 37)
+			a = (a & 0xF8) | vdu_ansi_col[p-30];
+		else if (p == 39)
+			a = (a & 0xF0) | (vdu->attr_def & 0x0F);
+		else if (p >= 40 && p <= 47)
+			a = (a & 0x0F) | (vdu_ansi_col[p-40] << 4);
+		else if (p == 49)
+			a = (a & 0x0F) | (vdu->attr_def & 0xF0);
+		else if (p >= 90 && p <= 97)
+			a = (a & 0xF0) | 0x08 | vdu_ansi_col[p-90];
+		else if (p >= 100 && p <= 107)
+			a = (a & 0x0F) | ((0x08 | vdu_ansi_col[p-100]) << 4);
+	}
+	vdu->attr = vdu->rev ? ATTR_SWAP(a) : a;
+}
+
+// CSI (control sequence introducer) final character
+static void vdu_csi(char c)
+{
+	uint8_t p0, p1, n;
+
+	p0 = vdu->csi_p[0];
+	p1 = vdu->csi_p[1];
+	n = p0 ? p0 : 1;
+	switch(c) {
+		case 'A' :	// CUU: cursor up
+			vdu->y = vdu->y > n ? vdu->y-n : 0;
+			break;
+		case 'B' :	// CUD: cursor down
+			vdu->y = vdu->y+n < vdu_height ? vdu->y+n : vdu_height-1;
+			break;
+		case 'C' :	// CUF: cursor forward
+			vdu->x = vdu->x+n < vdu_width ? vdu->x+n : vdu_width-1;
+			break;
+		case 'D' :	// CUB: cursor back
+			vdu->x = vdu->x > n ? vdu->x-n : 0;
+			break;
+		case 'H' :	// CUP: cursor position (row;col, 1 based)
+		case 'f' :
+			vdu->y = p0 ? (p0 <= vdu_height ? p0-1 : vdu_height-1) : 0;
+			vdu->x = p1 ? (p1 <= vdu_width ? p1-1 : vdu_width-1) : 0;
+			break;
+		case 'J' :	// ED: erase in display
+			if (p0 == 0)
+				vdu_hal_erase(vdu->x+(vdu->y*vdu_width), (vdu_width*vdu_height)-(vdu->x+(vdu->y*vdu_width)));
+			else if (p0 == 1)
+				vdu_hal_erase(0, vdu->x+(vdu->y*vdu_width)+1);
+			else if (p0 == 2)
+				vdu_hal_erase(0, vdu_width*vdu_height);
+			break;
+		case 'K' :	// EL: erase in line
+			if (p0 == 0)
+				vdu_hal_erase(vdu->x+(vdu->y*vdu_width), vdu_width-vdu->x);
+			else if (p0 == 1)
+				vdu_hal_erase(vdu->y*vdu_width, vdu->x+1);
+			else if (p0 == 2)
+				vdu_hal_erase(vdu->y*vdu_width, vdu_width);
+			break;
+		case 'm' :	// SGR: select graphic rendition
+			vdu_sgr();
+			break;
+		case 'r' :	// DECSTBM: set scroll region (top;bottom, 1 based)
+			p0 = p0 ? p0-1 : 0;
+			p1 = (p1 && p1 <= vdu_height) ? p1-1 : vdu_height-1;
+			if (p0 < p1) {
+				vdu->top = p0;
+				vdu->bottom = p1;
+				vdu->x = 0;
+				vdu->y = 0;
+			}
+			break;
+		case 's' :	// save cursor
+			vdu->saved_x = vdu->x;
+			vdu->saved_y = vdu->y;
+			break;
+		case 'u' :	// restore cursor
+			vdu->x = vdu->saved_x;
+			vdu->y = vdu->saved_y;
+			break;
+	}
+}
+
+// characters are interpreted as a subset of VT100/ANSI:
+//  BS, HT, LF (also returns the cursor to column 0), CR
+//  ESC D (index), ESC M (reverse index), ESC E (next line),
+//  ESC 7 / ESC 8 (save/restore cursor and attribute), ESC c (reset)
+//  CSI A/B/C/D/H/f/J/K/m/r/s/u (see vdu_csi above)
+void vdu_putc(void *p, char c)
+{
+	uint16_t d;
+
+	switch(vdu->esc) {
+		case ESC_NONE :
+			break;
+		case ESC_ESC :
+			vdu->esc = ESC_NONE;
+			switch(c) {
+				case '[' :
+					vdu->esc = ESC_CSI;
+					vdu->csi_n = 0;
+					memset(vdu->csi_p, 0, sizeof(vdu->csi_p));
+					break;
+				case 'D' :
+					vdu_index();
+					break;
+				case 'M' :
+					vdu_reverse_index();
+					break;
+				case 'E' :
+					vdu_newline();
+					break;
+				case '7' :
+					vdu->saved_x = vdu->x;
+					vdu->saved_y = vdu->y;
+					vdu->saved_attr = vdu->attr;
+					vdu->saved_rev = vdu->rev;
+					break;
+				case '8' :
+					vdu->x = vdu->saved_x;
+					vdu->y = vdu->saved_y;
+					vdu->attr = vdu->saved_attr;
+					vdu->rev = vdu->saved_rev;
+					break;
+				case 'c' :
+					vdu->attr = vdu->attr_def;
+					vdu->rev = 0;
+					vdu->top = 0;
+					vdu->bottom = vdu_height-1;
+					vdu->x = 0;
+					vdu->y = 0;
+					vdu_hal_erase(0, vdu_width*vdu_height);
+					break;
+			}
+			return;
+		case ESC_CSI :
+			if (c >= '0' && c <= '9') {
+				d = (vdu->csi_p[vdu->csi_n]*10) + (c-'0');
+				vdu->csi_p[vdu->csi_n] = d > 255 ? 255 : d;
+			}
+			else if (c == ';') {
+				if (vdu->csi_n < CSI_PARAMS-1)
+					vdu->csi_n++;
+			}
+			else if (c >= 0x40 && c <= 0x7E) {
+				vdu->esc = ESC_NONE;
+				vdu_csi(c);
+			}
+			else if (c == 24 || c == 26) // CAN, SUB: abort sequence
+				vdu->esc = ESC_NONE;
+			return;
+	}
+	if ((uint8_t)c >= 32) { // display characters 32..255
+		vdu_hal_put(vdu->x++, vdu->y, (vdu->attr << 8) | (uint8_t)c);
+		if (vdu->x == vdu_width) {
+			vdu_newline();
+		}
+	}
+	else { // control characters 0..31
+		switch(c) {
+			case 8 :	// backspace
+				if (vdu->x)
+					vdu->x--;
+				break;
+			case 9 :	// horizontal tab
+				vdu->x = (vdu->x+8) & ~7;
+				if (vdu->x >= vdu_width)
+					vdu->x = vdu_width-1;
+				break;
+			case 10 :	// newline
+				vdu_newline();
+				break;
+			case 13 :	// CR
+				vdu->x = 0;
+				break;
+			case 27 :	// ESC
+				vdu->esc = ESC_ESC;
+				break;
+		}
+	}
+}
+
+void vdu_write(const char *s, size_t n)
+{
+	size_t i, r;
+
+	while (n) {
+		if (vdu->esc == ESC_NONE && (uint8_t)*s >= 32) { // run of display characters, up to end of line
+			r = vdu_width - vdu->x;
+			if (r > n)
+				r = n;
+			for (i = 1; i < r && (uint8_t)s[i] >= 32; i++)
+				;
+			vdu_hal_write(vdu->x, vdu->y, s, i);
+			vdu->x += i;
+			if (vdu->x == vdu_width)
+				vdu_newline();
+		}
+		else { // control characters and escape sequences
+			i = 1;
+			vdu_putc(NULL, *s);
+		}
+		s += i;
+		n -= i;
+	}
+}
+
+void vdu_puts(const char *s)
+{
+	vdu_write(s, strlen(s));
+}
+
+void vdu_putw(void *p, const char *s, size_t n)
+{
+	vdu_write(s, n);
+}
@@ -0,0 +1,70 @@
+/*******************************************************************************
+** vdu_term.h                                                                 **
+** Console state and escape sequence handling shared by VDU drivers.          **
+********************************************************************************
+** (C) Copyright 2021 Adam Barnes <ambarnes@gmail.com>                        **
+** This file is part of The Tyto Project. The Tyto Project is free software:  **
+** you can redistribute it and/or modify it under the terms of the GNU Lesser **
+** General Public License as published by the Free Software Foundation,       **
+** either version 3 of the License, or (at your option) any later version.    **
+** The Tyto Project is distributed in the hope that it will be useful, but    **
+** WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY **
+** or FITNESS FOR A PARTICULAR PURPOSE. See the GNU Lesser General Public     **
+** License for more details. You should have received a copy of the GNU       **
+** Lesser General Public License along with The Tyto Project. If not, see     **
+** https://www.gnu.org/licenses/.                                             **
+*******************************************************************************/
+
+#ifndef _VDU_TERM_H_
+#define _VDU_TERM_H_
+
+#include <stdint.h>
+
+#include "vdu.h"
+
+// vdu_term.c implements the display independent part of the vdu.h API
+// (cursor, attributes, escape sequences and printf output) for a display
+// driver (vdu.c, fb_vdu.c), which holds the character cells and provides
+// the rest of the API and the vdu_hal_xxx functions below. Only one
+// driver is linked into an application.
+
+// escape sequence parser state
+#define ESC_NONE	0
+#define ESC_ESC		1
+#define ESC_CSI		2
+#define CSI_PARAMS	4
+
+// virtual console: a character buffer page, with its own cursor and attribute state
+typedef struct {
+	uintptr_t buf;					// character buffer base address
+	uint8_t x;
+	uint8_t y;
+	uint8_t attr;
+	uint8_t attr_def;				// attribute restored by SGR 0
+	uint8_t rev;					// reverse video (SGR 7): attr holds fg and bg swapped
+	uint8_t top;					// scroll region top row
+	uint8_t bottom;					// scroll region bottom row
+	uint8_t saved_x;
+	uint8_t saved_y;
+	uint8_t saved_attr;
+	uint8_t saved_rev;
+	uint8_t esc;					// escape sequence parser state
+	uint8_t csi_n;					// index of current parameter
+	uint8_t csi_p[CSI_PARAMS];
+} vdu_con_t;
+
+extern vdu_con_t vdu_con[VDU_CONSOLES];
+extern vdu_con_t *vdu;			// console selected for output
+extern uint8_t vdu_shown;		// console selected for display
+extern uint8_t vdu_width;		// characters
+extern uint8_t vdu_height;
+
+void vdu_term_init(uint8_t width, uint8_t height, uintptr_t buf, uint32_t page_size);
+uint8_t vdu_term_clip(uint8_t x, uint8_t y, uint8_t *w, uint8_t *h);
+
+// provided by the display driver; all act on the selected console (vdu)
+void vdu_hal_erase(uint16_t i, uint16_t n);	// fill n cells from cell index i (row major) with character 0 in the current attribute
+void vdu_hal_put(uint8_t x, uint8_t y, uint16_t d);	// set cell (x,y) to d (attribute in bits 15:8, character in 7:0)
+void vdu_hal_write(uint8_t x, uint8_t y, const char *s, uint8_t n);	// write n characters in the current attribute from (x,y), within one line
+
+#endif
@@ -95,7 +95,10 @@ begin
             fb_vs       => crtc_vs,
             fb_hs       => crtc_hs,
             fb_vblank   => crtc_vblank,
-            fb_hblank   => crtc_hblank
+            fb_hblank   => crtc_hblank,
+            sys_vs      => open,
+            sys_vblank  => open,
+            sys_ay      => open
         );
 
     U_BRIDGE_CRTC: component mig_bridge_crtc
@@ -123,7 +126,11 @@ begin
             mig_wdata       => mig_wdata,
             mig_wbe         => mig_wbe,
             mig_rdata       => mig_rdata,
-            mig_rvalid      => mig_rvalid
+            mig_rvalid      => mig_rvalid,
+            mig_page        => '0',
+            mig_page_disp   => open,
+            mig_fmt         => "00",
+            mig_scale       => "00"
         );
 
     -- simple shim in place of hub
@@ -40,4 +40,7 @@ set mb_files [list \
     "lib/axi_fifo_mm.c" \
     "lib/axi_fifo_mm.h" \
     "lib/axi_fifo_mm_p.h" \
+    "lib/binlog.c" \
+    "lib/binlog.h" \
+    "lib/binlog_p.h" \
 ]
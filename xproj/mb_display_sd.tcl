@@ -44,6 +44,8 @@ set mb_files [list \
     "lib/axi_gpio.c" \
     "lib/vdu.h" \
     "lib/vdu.c" \
+    "lib/vdu_term.h" \
+    "lib/vdu_term.c" \
     "lib/printf.h" \
     "lib/printf.c" \
 ]
@@ -53,12 +53,42 @@ set mb_files [list \
     "dsn/${xbuild_design}/main.c" \
     "dsn/${xbuild_design}/hagl_hal.c" \
     "dsn/${xbuild_design}/hagl_hal.h" \
+    "dsn/${xbuild_design}/bench.c" \
+    "dsn/${xbuild_design}/bench.h" \
+    "dsn/${xbuild_design}/vdu_demo.c" \
+    "dsn/${xbuild_design}/vdu_demo.h" \
     "lib/peekpoke.h" \
     "lib/axi_gpio_p.h" \
     "lib/axi_gpio.h" \
     "lib/axi_gpio.c" \
+    "lib/axi_timer_p.h" \
+    "lib/axi_timer.h" \
+    "lib/axi_timer.c" \
+    "lib/axi_uartlite_p.h" \
+    "lib/axi_uartlite.h" \
+    "lib/axi_uartlite.c" \
+    "lib/printf.h" \
+    "lib/printf.c" \
     "lib/fb.h" \
     "lib/fb.c" \
+    "lib/fb_tile.h" \
+    "lib/fb_tile.c" \
+    "lib/fb_blit.h" \
+    "lib/fb_blit.c" \
+    "lib/fb_glyph.h" \
+    "lib/fb_glyph.c" \
+    "lib/fb_raster.h" \
+    "lib/fb_raster.c" \
+    "lib/fb_qoi.h" \
+    "lib/fb_qoi.c" \
+    "lib/fb_copy.h" \
+    "lib/fb_copy.c" \
+    "lib/vdu.h" \
+    "lib/fb_vdu.c" \
+    "lib/vdu_term.h" \
+    "lib/vdu_term.c" \
+    "lib/font_437_8x16.h" \
+    "lib/font_437_8x16.c" \
 ]
 set mb_submodule_files [list \
     "hagl/src/bitmap.c" \